@@ -0,0 +1,90 @@
+#ifndef ANIMATION_ASSETS_H
+#define ANIMATION_ASSETS_H
+
+// Progressive asset pipeline.
+// CPU work (OBJ parsing, procedural generation) runs on std::async workers;
+// finished vertex data is copied to the GPU a slice at a time under a
+// per-frame byte budget so a large mesh never stalls a frame.
+
+#include <vector>
+#include <deque>
+#include <future>
+#include <chrono>
+#include <algorithm>
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+const size_t UPLOAD_BUDGET_BYTES = 4 * 1024 * 1024;
+
+// Interleaved position + normal mesh, drawable once vertexCount is non-zero
+struct GpuMesh {
+    GLuint vao = 0, vbo = 0;
+    GLsizei vertexCount = 0;
+    size_t bytes = 0;
+
+    bool ready() const { return vertexCount > 0; }
+
+    void destroy() {
+        if (vao) glDeleteVertexArrays(1, &vao);
+        if (vbo) glDeleteBuffers(1, &vbo);
+        vao = vbo = 0; vertexCount = 0; bytes = 0;
+    }
+};
+
+// Poll a worker result without blocking the render loop
+template <class T>
+bool isReady(const std::future<T>& f) {
+    return f.valid() && f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+class UploadQueue {
+public:
+    explicit UploadQueue(size_t budgetBytes = UPLOAD_BUDGET_BYTES) : budget(budgetBytes), totalBytes(0), busyFrames(0) {}
+
+    // Allocate GPU storage now; the data itself goes up over the next frames
+    void enqueue(GpuMesh& mesh, std::vector<float>&& vertices) {
+        glGenVertexArrays(1, &mesh.vao); glGenBuffers(1, &mesh.vbo);
+        glBindVertexArray(mesh.vao); glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+        mesh.bytes = vertices.size()*sizeof(float);
+        glBufferData(GL_ARRAY_BUFFER, mesh.bytes, NULL, GL_STATIC_DRAW);
+        glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)0); glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)(3*sizeof(float))); glEnableVertexAttribArray(1);
+        pending.push_back(Pending{&mesh, std::move(vertices), 0});
+    }
+
+    // Upload up to the budget; call once per frame
+    void pump() {
+        if (pending.empty()) return;
+        size_t remaining = budget;
+        while (!pending.empty() && remaining > 0) {
+            Pending& p = pending.front();
+            size_t size = p.vertices.size() * sizeof(float);
+            size_t chunk = std::min(remaining, size - p.offset);
+            glBindBuffer(GL_ARRAY_BUFFER, p.mesh->vbo);
+            glBufferSubData(GL_ARRAY_BUFFER, p.offset, chunk, (const char*)p.vertices.data() + p.offset);
+            p.offset += chunk; remaining -= chunk; totalBytes += chunk;
+            if (p.offset == size) {
+                p.mesh->vertexCount = p.vertices.size() / 6;
+                pending.pop_front();
+            }
+        }
+        busyFrames++;
+    }
+
+    bool idle() const { return pending.empty(); }
+    size_t bytesUploaded() const { return totalBytes; }
+    unsigned long framesUsed() const { return busyFrames; }
+
+private:
+    struct Pending {
+        GpuMesh* mesh;
+        std::vector<float> vertices;
+        size_t offset;
+    };
+    std::deque<Pending> pending;
+    size_t budget;
+    size_t totalBytes;
+    unsigned long busyFrames;
+};
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef ANIMATION_BENCH_H
+#define ANIMATION_BENCH_H
+
+// Scene-scaling benchmark support.
+//   Animation --bench buildings=200 windows=2 lights=32 width=1920 height=1080 frames=600 shadows=1 csv=results.csv
+// renders a fixed camera path into an offscreen target and reports frame-time
+// percentiles, draw calls, triangles and memory. Each run appends one CSV row
+// so option sweeps can be kept as a baseline.
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+// Scene size knobs; the defaults reproduce the normal animation
+struct SceneConfig {
+    int buildings = 20;
+    float windowDensity = 1.0f;   // windows per 3x3 unit cell of facade
+    int lights = 7;               // streetlights, spread along the road
+};
+
+struct BenchConfig {
+    bool enabled = false;
+    SceneConfig scene;
+    int width = 1280, height = 720;
+    int frames = 600;
+    int warmupFrames = 30;
+    bool shadows = true;
+    std::string csvPath;
+};
+
+// Parse "--bench key=value ..."; returns false on a malformed argument
+inline bool parseBenchArgs(int argc, char** argv, int maxLights, BenchConfig& cfg) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bench") { cfg.enabled = true; continue; }
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos) { std::cerr << "Unknown argument " << arg << std::endl; return false; }
+        std::string key = arg.substr(0, eq), value = arg.substr(eq + 1);
+        if (key == "buildings") cfg.scene.buildings = std::max(1, atoi(value.c_str()));
+        else if (key == "windows") cfg.scene.windowDensity = std::max(0.1f, (float)atof(value.c_str()));
+        else if (key == "lights") cfg.scene.lights = std::min(maxLights, std::max(0, atoi(value.c_str())));
+        else if (key == "width") cfg.width = std::max(1, atoi(value.c_str()));
+        else if (key == "height") cfg.height = std::max(1, atoi(value.c_str()));
+        else if (key == "frames") cfg.frames = std::max(1, atoi(value.c_str()));
+        else if (key == "warmup") cfg.warmupFrames = std::max(0, atoi(value.c_str()));
+        else if (key == "shadows") cfg.shadows = atoi(value.c_str()) != 0;
+        else if (key == "csv") cfg.csvPath = value;
+        else { std::cerr << "Unknown benchmark option " << key << std::endl; return false; }
+    }
+    return true;
+}
+
+// Per-frame counters fed by countedDrawArraysInstanced
+struct RenderCounters {
+    unsigned long drawCalls = 0;
+    unsigned long long triangles = 0;
+};
+
+inline RenderCounters& renderCounters() {
+    static RenderCounters counters;
+    return counters;
+}
+
+inline void countedDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) {
+    glDrawArraysInstanced(mode, first, count, instances);
+    RenderCounters& c = renderCounters();
+    c.drawCalls++;
+    if (mode == GL_TRIANGLES) c.triangles += (unsigned long long)(count / 3) * instances;
+}
+
+// Offscreen colour + depth target so resolution does not depend on the window
+struct BenchTarget {
+    GLuint fbo = 0, color = 0, depth = 0;
+
+    void init(int width, int height) {
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glGenRenderbuffers(1, &color);
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        glGenRenderbuffers(1, &depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::cerr << "Benchmark Framebuffer Incomplete" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void destroy() {
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        if (color) glDeleteRenderbuffers(1, &color);
+        if (depth) glDeleteRenderbuffers(1, &depth);
+    }
+};
+
+struct BenchSample {
+    double frameMs;
+    unsigned long drawCalls;
+    unsigned long long triangles;
+};
+
+struct BenchResult {
+    size_t gpuBytes = 0;      // buffers, textures and targets this app allocated
+    size_t sceneBytes = 0;    // CPU-side city layout
+    std::vector<BenchSample> samples;
+};
+
+inline double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t rank = (size_t)(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(rank, values.size() - 1)];
+}
+
+inline void reportBench(const BenchConfig& cfg, const BenchResult& r, size_t litWindows, size_t darkWindows, size_t lights) {
+    std::vector<double> ms;
+    double drawCalls = 0.0, triangles = 0.0;
+    for (const BenchSample& s : r.samples) { ms.push_back(s.frameMs); drawCalls += s.drawCalls; triangles += (double)s.triangles; }
+    size_t n = std::max<size_t>(1, r.samples.size());
+    double p50 = percentile(ms, 50), p90 = percentile(ms, 90), p99 = percentile(ms, 99), pmax = percentile(ms, 100);
+    double gpuMB = r.gpuBytes / (1024.0 * 1024.0), sceneMB = r.sceneBytes / (1024.0 * 1024.0);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Benchmark: " << cfg.scene.buildings << " buildings, " << (litWindows + darkWindows) << " windows, "
+              << lights << " lights, " << cfg.width << "x" << cfg.height << ", shadows " << (cfg.shadows ? "on" : "off")
+              << ", " << r.samples.size() << " frames" << std::endl
+              << "  frame ms     p50 " << p50 << "  p90 " << p90 << "  p99 " << p99 << "  max " << pmax << std::endl
+              << "  draw calls   " << drawCalls / n << " / frame" << std::endl
+              << "  triangles    " << std::setprecision(0) << triangles / n << " / frame" << std::endl
+              << std::setprecision(2)
+              << "  memory       gpu " << gpuMB << " MB  scene " << sceneMB << " MB" << std::endl;
+
+    if (cfg.csvPath.empty()) return;
+    bool exists = std::ifstream(cfg.csvPath).good();
+    std::ofstream csv(cfg.csvPath, std::ios::app);
+    if (!csv) { std::cerr << "Failed to open " << cfg.csvPath << std::endl; return; }
+    if (!exists) csv << "buildings,window_density,windows,lights,width,height,shadows,frames,p50_ms,p90_ms,p99_ms,max_ms,draw_calls,triangles,gpu_mb,scene_mb\n";
+    csv << std::fixed << std::setprecision(3)
+        << cfg.scene.buildings << "," << cfg.scene.windowDensity << "," << (litWindows + darkWindows) << "," << lights << ","
+        << cfg.width << "," << cfg.height << "," << (cfg.shadows ? 1 : 0) << "," << r.samples.size() << ","
+        << p50 << "," << p90 << "," << p99 << "," << pmax << ","
+        << drawCalls / n << "," << triangles / n << "," << gpuMB << "," << sceneMB << "\n";
+}
+
+#endif
@@ -5,6 +5,10 @@
 #include <sstream>
 #include <cmath>
 #include <cstdlib>
+#include <cstddef>
+#include <chrono>
+#include <future>
+#include <stdexcept>
 
 // Third-Party Libraries
 #define GLEW_STATIC
@@ -19,152 +23,262 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
 
+// Cascaded Shadow Maps
+#include "shadows.h"
+
+// Background Asset Loading
+#include "assets.h"
+
+// Benchmark Mode
+#include "bench.h"
+
+// Per-Frame Upload Ring
+#include "upload_ring.h"
+
 // Configuration
 const unsigned int SCR_WIDTH = 1280;
 const unsigned int SCR_HEIGHT = 720;
-const int MAX_POINT_LIGHTS = 10;
+const int MAX_POINT_LIGHTS = 32; // must match pointLights[] in FrameData
 const char* CAR_MODEL_PATH = "bin\\Debug\\Porshe911CarreraGTS.obj";
 const float CAR_SCALE_FACTOR = 1.5f;
+const glm::vec3 CAR_PLACEHOLDER_SIZE(1.2f, 0.9f, 2.9f);
+const float CAMERA_NEAR = 0.1f;
+const float CAMERA_FAR = 200.0f;
+const float SHADOW_SPLITS[NUM_CASCADES + 1] = { CAMERA_NEAR, 45.0f, 100.0f, CAMERA_FAR };
+const glm::vec3 MOON_LIGHT_DIR(-20.0f, -50.0f, -20.0f);
+const double STATS_INTERVAL = 5.0;
+
+// Per-frame and per-draw uniform blocks, filled from the upload ring.
+// The C++ mirrors below follow std140 layout: only mat4, vec4 and
+// 4-byte scalars, with every vec4 on a 16-byte boundary.
+const GLuint FRAME_DATA_BINDING = 0;
+const GLuint DRAW_DATA_BINDING = 1;
+const std::string FRAME_DATA_GLSL = R"(
+struct PointLight {
+    vec4 position;
+    vec4 color;
+    vec4 attenuation; // constant, linear, quadratic
+};
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    mat4 lightSpaceMatrices[3];
+    vec4 viewPos;
+    vec4 dirLightDir;
+    vec4 dirLightColor;
+    vec4 fogColor;
+    vec4 cascadeSplits;
+    float ambientStrength;
+    float specularStrength;
+    float fogDensity;
+    int numPointLights;
+    PointLight pointLights[32];
+};
+)";
+const std::string DRAW_DATA_GLSL = R"(
+layout (std140) uniform DrawData {
+    vec4 objectColor;
+    int shininess;
+    int cascade;
+};
+)";
+
+struct PointLightStd140 {
+    glm::vec4 position, color, attenuation;
+};
+struct FrameUniforms {
+    glm::mat4 projection, view;
+    glm::mat4 lightSpaceMatrices[NUM_CASCADES];
+    glm::vec4 viewPos, dirLightDir, dirLightColor, fogColor;
+    glm::vec4 cascadeSplits;
+    float ambientStrength, specularStrength, fogDensity;
+    int numPointLights;
+    PointLightStd140 pointLights[MAX_POINT_LIGHTS];
+};
+struct DrawUniforms {
+    glm::vec4 objectColor;
+    int shininess, cascade, pad[2];
+};
+static_assert(offsetof(FrameUniforms, ambientStrength) == 400 && offsetof(FrameUniforms, pointLights) == 416,
+              "FrameUniforms does not match the std140 FrameData layout");
 
 // Multi-Light Phong Shader
-const char* phongVertexShaderSource = R"(
+const std::string phongVertexShaderSource = std::string(R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
+layout (location = 2) in mat4 aModel;
 out vec3 FragPos;
 out vec3 Normal;
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+)") + FRAME_DATA_GLSL + R"(
 void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    FragPos = vec3(aModel * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(aModel))) * aNormal;
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
 )";
-const char* phongFragmentShaderSource = R"(
+const std::string phongFragmentShaderSource = std::string(R"(
 #version 330 core
 out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
-struct PointLight {
-    vec3 position;
-    vec3 color;
-    float constant;
-    float linear;
-    float quadratic;
-};
-uniform vec3 objectColor;
-uniform vec3 viewPos;
-uniform float ambientStrength;
-uniform float specularStrength;
-uniform int shininess;
-uniform PointLight pointLights[10];
-uniform int numPointLights;
-uniform vec3 dirLightDir;
-uniform vec3 dirLightColor;
-uniform vec3 fogColor;
-uniform float fogDensity;
+)") + FRAME_DATA_GLSL + DRAW_DATA_GLSL + R"(
+uniform sampler2DArrayShadow shadowMap;
+
+float CalcDirShadow(vec3 normal, vec3 lightDir) {
+    float depth = -(view * vec4(FragPos, 1.0)).z;
+    int layer = 0;
+    while (layer < 2 && depth > cascadeSplits[layer]) layer++;
+    if (depth > cascadeSplits[2]) return 0.0;
+    vec4 lightSpacePos = lightSpaceMatrices[layer] * vec4(FragPos + normal * 0.05, 1.0);
+    vec3 proj = lightSpacePos.xyz / lightSpacePos.w * 0.5 + 0.5;
+    if (proj.z > 1.0) return 0.0;
+    float bias = max(0.002 * (1.0 - dot(normal, lightDir)), 0.0005);
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float lit = 0.0;
+    for (int x = -1; x <= 1; ++x)
+        for (int y = -1; y <= 1; ++y)
+            lit += texture(shadowMap, vec4(proj.xy + vec2(x, y) * texel, float(layer), proj.z - bias));
+    return 1.0 - lit / 9.0;
+}
 
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
-    vec3 lightDir = normalize(light.position - fragPos);
+    vec3 lightDir = normalize(light.position.xyz - fragPos);
     float diff = max(dot(normal, lightDir), 0.0);
-    vec3 diffuse = diff * light.color;
+    vec3 diffuse = diff * light.color.rgb;
     vec3 reflectDir = reflect(-lightDir, normal);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), float(shininess));
-    vec3 specular = specularStrength * spec * light.color;
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    vec3 specular = specularStrength * spec * light.color.rgb;
+    float distance = length(light.position.xyz - fragPos);
+    float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance + light.attenuation.z * (distance * distance));
     return (diffuse + specular) * attenuation;
 }
 
 void main() {
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 lightDir = normalize(-dirLightDir);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
+    vec3 lightDir = normalize(-dirLightDir.xyz);
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * dirLightColor;
-    vec3 result = (ambientStrength * dirLightColor) + diffuse;
+    vec3 diffuse = diff * dirLightColor.rgb * (1.0 - CalcDirShadow(norm, lightDir));
+    vec3 result = (ambientStrength * dirLightColor.rgb) + diffuse;
     for (int i = 0; i < numPointLights; i++) {
         result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
     }
-    result *= objectColor;
-    float dist = length(viewPos - FragPos);
+    result *= objectColor.rgb;
+    float dist = length(viewPos.xyz - FragPos);
     float fogFactor = exp(-pow(dist * fogDensity, 2.0));
-    FragColor = mix(vec4(fogColor, 1.0), vec4(result, 1.0), clamp(fogFactor, 0.0, 1.0));
+    FragColor = mix(vec4(fogColor.rgb, 1.0), vec4(result, 1.0), clamp(fogFactor, 0.0, 1.0));
 }
 )";
 
 // Emission Shader
-const char* emissionVertexShaderSource = R"(
+const std::string emissionVertexShaderSource = std::string(R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (location = 2) in mat4 aModel;
+)") + FRAME_DATA_GLSL + R"(
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * aModel * vec4(aPos, 1.0);
 }
 )";
-const char* emissionFragmentShaderSource = R"(
+const std::string emissionFragmentShaderSource = std::string(R"(
 #version 330 core
 out vec4 FragColor;
-uniform vec3 objectColor;
+)") + DRAW_DATA_GLSL + R"(
 void main() {
-    FragColor = vec4(objectColor, 1.0);
+    FragColor = vec4(objectColor.rgb, 1.0);
 }
 )";
 
+// Shadow Depth Shader
+const std::string depthVertexShaderSource = std::string(R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in mat4 aModel;
+)") + FRAME_DATA_GLSL + DRAW_DATA_GLSL + R"(
+void main() {
+    gl_Position = lightSpaceMatrices[cascade] * aModel * vec4(aPos, 1.0);
+}
+)";
+const std::string depthFragmentShaderSource = R"(
+#version 330 core
+void main() {}
+)";
+
+// Procedurally placed city objects
+struct CityLayout {
+    std::vector<glm::mat4> buildingModels, darkWindowModels, litWindowModels, streetlightPostModels, streetlightLampModels, streetlightHoodModels;
+    std::vector<glm::vec3> pointLightPositions;
+};
+
 // Function Prototypes
 GLuint compileShader(const char* vertexSource, const char* fragmentSource);
+void bindUniformBlocks(GLuint shader);
 glm::vec3 getBezierPoint(float t, const std::vector<glm::vec3>& controlPoints);
 glm::vec3 getBezierTangent(float t, const std::vector<glm::vec3>& controlPoints);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+double millisecondsSince(std::chrono::steady_clock::time_point start);
+std::vector<float> tessellateRoad(const std::vector<glm::vec3>& roadControlPoints);
+CityLayout generateCity(const std::vector<glm::vec3>& roadControlPoints, SceneConfig config);
+std::vector<float> loadCarMesh(const char* path);
 
 // Main Application
-int main() {
+int main(int argc, char** argv) {
+    auto startTime = std::chrono::steady_clock::now();
+    BenchConfig bench;
+    if (!parseBenchArgs(argc, argv, MAX_POINT_LIGHTS, bench)) return -1;
+
     // Initialize GLFW and GLEW
     if (!glfwInit()) { std::cerr << "Failed to initialize GLFW" << std::endl; return -1; }
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (bench.enabled) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
     GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Neon Velocity - OpenGL", NULL, NULL);
     if (window == NULL) { std::cerr << "Failed to create GLFW window" << std::endl; glfwTerminate(); return -1; }
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glewExperimental = GL_TRUE;
     if (glewInit() != GLEW_OK) { std::cerr << "Failed to initialize GLEW" << std::endl; return -1; }
+    if (bench.enabled) glfwSwapInterval(0);
 
     // Set OpenGL state
     glEnable(GL_DEPTH_TEST);
     glClearColor(0.05f, 0.05f, 0.1f, 1.0f);
 
     // Compile shaders
-    GLuint phongShader = compileShader(phongVertexShaderSource, phongFragmentShaderSource);
-    GLuint emissionShader = compileShader(emissionVertexShaderSource, emissionFragmentShaderSource);
+    GLuint phongShader = compileShader(phongVertexShaderSource.c_str(), phongFragmentShaderSource.c_str());
+    GLuint emissionShader = compileShader(emissionVertexShaderSource.c_str(), emissionFragmentShaderSource.c_str());
+    GLuint depthShader = compileShader(depthVertexShaderSource.c_str(), depthFragmentShaderSource.c_str());
+    bindUniformBlocks(phongShader); bindUniformBlocks(emissionShader); bindUniformBlocks(depthShader);
+    glUseProgram(phongShader);
+    glUniform1i(glGetUniformLocation(phongShader, "shadowMap"), 0);
+
+    // Every per-frame uniform and instance transform is streamed through this
+    UploadRing ring;
+    ring.init();
 
-    // Procedurally generate road geometry
+    // Road centre line
     std::vector<glm::vec3> roadControlPoints = {
         glm::vec3(-50.0f, 0.0f, 0.0f), glm::vec3(-25.0f, 0.0f, 0.0f),
         glm::vec3(25.0f, 0.0f, 50.0f), glm::vec3(50.0f, 0.0f, 50.0f)
     };
-    std::vector<float> roadVertices;
-    for (int i = 0; i < 100; ++i) {
-        float t1=(float)i/100, t2=(float)(i+1)/100;
-        glm::vec3 p1=getBezierPoint(t1,roadControlPoints), p2=getBezierPoint(t2,roadControlPoints);
-        glm::vec3 n1=glm::normalize(glm::cross(glm::normalize(getBezierTangent(t1,roadControlPoints)), glm::vec3(0,1,0)));
-        glm::vec3 n2=glm::normalize(glm::cross(glm::normalize(getBezierTangent(t2,roadControlPoints)), glm::vec3(0,1,0)));
-        glm::vec3 v1=p1-n1*5.0f, v2=p1+n1*5.0f, v3=p2-n2*5.0f, v4=p2+n2*5.0f;
-        roadVertices.insert(roadVertices.end(),{v1.x,v1.y,v1.z,0,1,0, v2.x,v2.y,v2.z,0,1,0, v3.x,v3.y,v3.z,0,1,0});
-        roadVertices.insert(roadVertices.end(),{v2.x,v2.y,v2.z,0,1,0, v4.x,v4.y,v4.z,0,1,0, v3.x,v3.y,v3.z,0,1,0});
-    }
-    GLuint roadVAO, roadVBO;
-    glGenVertexArrays(1,&roadVAO); glGenBuffers(1,&roadVBO);
-    glBindVertexArray(roadVAO); glBindBuffer(GL_ARRAY_BUFFER, roadVBO);
-    glBufferData(GL_ARRAY_BUFFER, roadVertices.size()*sizeof(float), &roadVertices[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)(3*sizeof(float))); glEnableVertexAttribArray(1);
 
+    // Start CPU-side asset work on worker threads; the render loop starts right away
+    std::future<std::vector<float>> roadJob = std::async(std::launch::async, tessellateRoad, roadControlPoints);
+    std::future<CityLayout> cityJob = std::async(std::launch::async, generateCity, roadControlPoints, bench.scene);
+    std::future<std::vector<float>> carJob = std::async(std::launch::async, loadCarMesh, CAR_MODEL_PATH);
+    GpuMesh roadMesh, carMesh;
+    CityLayout city;
+    UploadQueue uploads(bench.enabled ? (size_t)-1 : UPLOAD_BUDGET_BYTES);
+
+    // The benchmark measures the finished scene, so it waits for every asset
+    BenchTarget benchTarget;
+    BenchResult benchResult;
+    if (bench.enabled) {
+        roadJob.wait(); cityJob.wait(); carJob.wait();
+        benchTarget.init(bench.width, bench.height);
+    }
     // Define vertices for a generic cube
     float cubeVertices[]={-0.5f,-0.5f,-0.5f,0,0,-1,0.5f,-0.5f,-0.5f,0,0,-1,0.5f,0.5f,-0.5f,0,0,-1,0.5f,0.5f,-0.5f,0,0,-1,-0.5f,0.5f,-0.5f,0,0,-1,-0.5f,-0.5f,-0.5f,0,0,-1,-0.5f,-0.5f,0.5f,0,0,1,0.5f,-0.5f,0.5f,0,0,1,0.5f,0.5f,0.5f,0,0,1,0.5f,0.5f,0.5f,0,0,1,-0.5f,0.5f,0.5f,0,0,1,-0.5f,-0.5f,0.5f,0,0,1,-0.5f,0.5f,0.5f,-1,0,0,-0.5f,0.5f,-0.5f,-1,0,0,-0.5f,-0.5f,-0.5f,-1,0,0,-0.5f,-0.5f,-0.5f,-1,0,0,-0.5f,-0.5f,0.5f,-1,0,0,-0.5f,0.5f,0.5f,-1,0,0,0.5f,0.5f,0.5f,1,0,0,0.5f,0.5f,-0.5f,1,0,0,0.5f,-0.5f,-0.5f,1,0,0,0.5f,-0.5f,-0.5f,1,0,0,0.5f,-0.5f,0.5f,1,0,0,0.5f,0.5f,0.5f,1,0,0,-0.5f,-0.5f,-0.5f,0,-1,0,0.5f,-0.5f,-0.5f,0,-1,0,0.5f,-0.5f,0.5f,0,-1,0,0.5f,-0.5f,0.5f,0,-1,0,-0.5f,-0.5f,0.5f,0,-1,0,-0.5f,-0.5f,-0.5f,0,-1,0,-0.5f,0.5f,-0.5f,0,1,0,0.5f,0.5f,-0.5f,0,1,0,0.5f,0.5f,0.5f,0,1,0,0.5f,0.5f,0.5f,0,1,0,-0.5f,0.5f,0.5f,0,1,0,-0.5f,0.5f,-0.5f,0,1,0};
     GLuint cubeVAO, cubeVBO;
@@ -174,157 +288,220 @@ int main() {
     glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)0); glEnableVertexAttribArray(0);
     glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)(3*sizeof(float))); glEnableVertexAttribArray(1);
 
-    // Procedurally generate positions for buildings, lights, and windows
-    std::vector<glm::mat4> buildingModels, darkWindowModels, litWindowModels, streetlightPostModels, streetlightLampModels, streetlightHoodModels;
-    std::vector<glm::vec3> pointLightPositions;
-    for(int i=0;i<20;++i){
-        float t=(float)i/20;
-        glm::vec3 pos=getBezierPoint(t,roadControlPoints);
-        glm::vec3 tangent=glm::normalize(getBezierTangent(t,roadControlPoints));
-        glm::vec3 n=glm::normalize(glm::cross(tangent,glm::vec3(0,1,0)));
-        float side=(i%2==0)?1.0f:-1.0f;
-        float h=10.0f+(std::rand()%10)*4.0f, w=4.0f+(std::rand()%5), offset=5.0f+w;
-        glm::mat4 model=glm::translate(glm::mat4(1.0f),pos+n*side*offset+glm::vec3(0,h/2.0f,0));
-        model=glm::rotate(model,(float)atan2(tangent.x,tangent.z),glm::vec3(0,1,0));
-        model=glm::scale(model,glm::vec3(w,h,w));
-        buildingModels.push_back(model);
-        for(float y=2.0f;y<h-2.0f;y+=3.0f){
-            for(float x=-w/2.0f+1.5f;x<w/2.0f-1.5f;x+=3.0f){
-                glm::mat4 winModel=glm::translate(model,glm::vec3(x/w,(y-h/2.0f)/h,0.51f));
-                winModel=glm::scale(winModel,glm::vec3(1.5f/w,1.5f/h,0.1f));
-                if(std::rand()%3==0)litWindowModels.push_back(winModel);else darkWindowModels.push_back(winModel);
-            }
-        }
-        if(i%3==0&&pointLightPositions.size()<MAX_POINT_LIGHTS){
-            glm::vec3 pPos=pos+n*side*(5.0f+1.0f);
-            glm::mat4 pModel=glm::translate(glm::mat4(1.0f),pPos+glm::vec3(0,3.0f,0));
-            pModel=glm::scale(pModel,glm::vec3(0.2f,6.0f,0.2f));
-            streetlightPostModels.push_back(pModel);
-            glm::vec3 lPos=pPos+glm::vec3(0,6.5f,0);
-            pointLightPositions.push_back(lPos);
-            glm::mat4 lModel=glm::translate(glm::mat4(1.0f),lPos);
-            lModel=glm::scale(lModel,glm::vec3(0.5f));
-            streetlightLampModels.push_back(lModel);
-            glm::mat4 hModel=glm::translate(glm::mat4(1.0f),lPos+glm::vec3(0,0.3f,0));
-            hModel=glm::scale(hModel,glm::vec3(0.8f,0.1f,0.8f));
-            streetlightHoodModels.push_back(hModel);
-        }
-    }
+    // Set up shadow cascades for the moonlight
+    CascadedShadowMap shadows;
+    shadows.init(SHADOW_SPLITS, MOON_LIGHT_DIR);
+    shadows.enabled = bench.shadows;
 
-    // Load the car model from the OBJ file
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-    if(!tinyobj::LoadObj(&attrib,&shapes,&materials,&warn,&err,CAR_MODEL_PATH)){throw std::runtime_error(warn+err);}
-    std::vector<float> carVertices;
-    for(const auto& shape:shapes){
-        for(const auto& index:shape.mesh.indices){
-            if(3*index.vertex_index+2<attrib.vertices.size()&&index.vertex_index>=0&&3*index.normal_index+2<attrib.normals.size()&&index.normal_index>=0){
-                carVertices.push_back(attrib.vertices[3*index.vertex_index+0]);carVertices.push_back(attrib.vertices[3*index.vertex_index+1]);carVertices.push_back(attrib.vertices[3*index.vertex_index+2]);
-                carVertices.push_back(attrib.normals[3*index.normal_index+0]);carVertices.push_back(attrib.normals[3*index.normal_index+1]);carVertices.push_back(attrib.normals[3*index.normal_index+2]);
-            }
+    // Per-frame instance transforms, pushed once and shared by every pass
+    RingSlice roadInstances, buildingInstances, darkWindowInstances, litWindowInstances,
+              postInstances, hoodInstances, lampInstances, carInstance, moonInstance;
+    auto pushInstances = [&](const glm::mat4* models, size_t count) {
+        return ring.push(models, count * sizeof(glm::mat4), sizeof(glm::vec4));
+    };
+    // One instanced draw; the material goes up as a DrawData block and the
+    // cascade index is only read by the depth shader
+    auto drawInstances = [&](GLuint vao, GLsizei vertexCount, const RingSlice& instances, glm::vec3 color, int shininess, int cascade) {
+        GLsizei count = instances.size / sizeof(glm::mat4);
+        if (count == 0) return;
+        DrawUniforms draw = { glm::vec4(color, 1.0f), shininess, cascade, {0, 0} };
+        RingSlice block = ring.pushUniforms(&draw, sizeof(draw));
+        glBindBufferRange(GL_UNIFORM_BUFFER, DRAW_DATA_BINDING, block.buffer, block.offset, block.size);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, instances.buffer);
+        for (int i = 0; i < 4; ++i) {
+            glVertexAttribPointer(2+i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(instances.offset + i*sizeof(glm::vec4)));
+            glEnableVertexAttribArray(2+i);
+            glVertexAttribDivisor(2+i, 1);
         }
-    }
-    GLuint carVAO, carVBO;
-    glGenVertexArrays(1,&carVAO); glGenBuffers(1,&carVBO);
-    glBindVertexArray(carVAO); glBindBuffer(GL_ARRAY_BUFFER,carVBO);
-    glBufferData(GL_ARRAY_BUFFER,carVertices.size()*sizeof(float),&carVertices[0],GL_STATIC_DRAW);
-    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)(3*sizeof(float))); glEnableVertexAttribArray(1);
+        countedDrawArraysInstanced(GL_TRIANGLES, 0, vertexCount, count);
+    };
+
+    // Draw everything that casts shadows; colours are ignored by the depth shader
+    auto drawStaticScene = [&](int cascade) {
+        if (roadMesh.ready()) drawInstances(roadMesh.vao, roadMesh.vertexCount, roadInstances, glm::vec3(0.15f, 0.15f, 0.15f), 256, cascade);
+        drawInstances(cubeVAO, 36, buildingInstances, glm::vec3(0.2f, 0.2f, 0.25f), 32, cascade);
+        drawInstances(cubeVAO, 36, darkWindowInstances, glm::vec3(0.05f, 0.05f, 0.05f), 32, cascade);
+        drawInstances(cubeVAO, 36, postInstances, glm::vec3(0.4f, 0.4f, 0.4f), 32, cascade);
+        drawInstances(cubeVAO, 36, hoodInstances, glm::vec3(0.4f, 0.4f, 0.4f), 32, cascade);
+    };
+    // Until the OBJ has been parsed and uploaded the car is a plain bounding box
+    auto drawCar = [&](int cascade) {
+        if (carMesh.ready()) drawInstances(carMesh.vao, carMesh.vertexCount, carInstance, glm::vec3(0.1f, 0.25f, 0.6f), 512, cascade);
+        else drawInstances(cubeVAO, 36, carInstance, glm::vec3(0.3f, 0.3f, 0.35f), 512, cascade);
+    };
 
     // Main Render Loop
+    double lastStatsTime = glfwGetTime();
+    bool firstFramePresented = false, fullyLoaded = false;
+    int frameIndex = 0;
     while (!glfwWindowShouldClose(window)) {
-        // Get animation progress
+        if (bench.enabled && frameIndex == bench.warmupFrames + bench.frames) break;
+        int benchFrame = frameIndex - bench.warmupFrames;
+        double frameStart = glfwGetTime();
+        renderCounters() = RenderCounters();
+
+        // Pick up finished worker results and feed the GPU within this frame's budget
+        if (isReady(roadJob)) uploads.enqueue(roadMesh, roadJob.get());
+        if (isReady(carJob)) {
+            try { uploads.enqueue(carMesh, carJob.get()); }
+            catch (const std::exception& e) { std::cerr << "Failed to load car model, keeping placeholder\n" << e.what() << std::endl; }
+        }
+        if (isReady(cityJob)) { city = cityJob.get(); shadows.invalidate(); }
+        bool staticPending = !roadMesh.ready();
+        uploads.pump();
+        if (staticPending && roadMesh.ready()) shadows.invalidate();
+        ring.beginFrame();
+
+        // Get animation progress; the benchmark walks the same path frame by frame
         float animProgress = fmod(glfwGetTime(), 10.0f) / 10.0f;
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if (bench.enabled) animProgress = benchFrame < 0 ? 0.0f : (float)benchFrame / bench.frames;
 
         // Define camera and projection
         float zoomFactor = 35.0f - (35.0f - 10.0f) * animProgress;
         float fov = 60.0f - (60.0f - 45.0f) * animProgress;
-        glm::mat4 projection = glm::perspective(glm::radians(fov), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 200.0f);
+        float aspect = bench.enabled ? (float)bench.width / (float)bench.height : (float)SCR_WIDTH / (float)SCR_HEIGHT;
+        glm::mat4 projection = glm::perspective(glm::radians(fov), aspect, CAMERA_NEAR, CAMERA_FAR);
         glm::vec3 carPos = getBezierPoint(animProgress, roadControlPoints);
         glm::vec3 carTangent = glm::normalize(getBezierTangent(animProgress, roadControlPoints));
         glm::vec3 cameraPos = carPos - carTangent * zoomFactor + glm::vec3(0, 5.0f, 0);
         glm::mat4 view = glm::lookAt(cameraPos, carPos, glm::vec3(0, 1, 0));
 
-        // Set uniforms for the Phong (main lighting) shader
-        glUseProgram(phongShader);
-        glUniformMatrix4fv(glGetUniformLocation(phongShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(phongShader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniform3f(glGetUniformLocation(phongShader, "viewPos"), cameraPos.x, cameraPos.y, cameraPos.z);
-        glUniform1f(glGetUniformLocation(phongShader, "ambientStrength"), 0.3f);
-        glUniform1f(glGetUniformLocation(phongShader, "specularStrength"), 1.0f);
-        glUniform3f(glGetUniformLocation(phongShader, "dirLightDir"), -20.0f, -50.0f, -20.0f);
-        glUniform3f(glGetUniformLocation(phongShader, "dirLightColor"), 0.6f, 0.6f, 0.7f);
-        glUniform3f(glGetUniformLocation(phongShader, "fogColor"), 0.05f, 0.05f, 0.1f);
-        glUniform1f(glGetUniformLocation(phongShader, "fogDensity"), 0.02f);
-        glUniform1i(glGetUniformLocation(phongShader, "numPointLights"), pointLightPositions.size());
-        for(int i = 0; i < pointLightPositions.size(); ++i) {
-            std::string base = "pointLights[" + std::to_string(i) + "]";
-            glUniform3fv(glGetUniformLocation(phongShader, (base+".position").c_str()), 1, &pointLightPositions[i][0]);
-            glUniform3f(glGetUniformLocation(phongShader, (base+".color").c_str()), 1.0f, 0.7f, 0.3f);
-            glUniform1f(glGetUniformLocation(phongShader, (base+".constant").c_str()), 1.0f);
-            glUniform1f(glGetUniformLocation(phongShader, (base+".linear").c_str()), 0.07f);
-            glUniform1f(glGetUniformLocation(phongShader, (base+".quadratic").c_str()), 0.017f);
+        // Place the car along the road
+        glm::mat4 carRotation = glm::inverse(glm::lookAt(glm::vec3(0.0f), carTangent, glm::vec3(0.0f, 1.0f, 0.0f)));
+        glm::mat4 carModel = glm::translate(glm::mat4(1.0f), carPos + glm::vec3(0, -0.2f, 0));
+        carModel = carModel * carRotation;
+        carModel = glm::rotate(carModel, glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        carModel = glm::scale(carModel, glm::vec3(CAR_SCALE_FACTOR));
+        if (!carMesh.ready()) {
+            carModel = glm::translate(carModel, glm::vec3(0.0f, CAR_PLACEHOLDER_SIZE.y / 2.0f, 0.0f));
+            carModel = glm::scale(carModel, CAR_PLACEHOLDER_SIZE);
+        }
+        glm::mat4 moonModel = glm::translate(glm::mat4(1.0f), glm::vec3(20.0f, 50.0f, 20.0f));
+        moonModel = glm::scale(moonModel, glm::vec3(5.0f));
+
+        // Stream this frame's instance transforms
+        glm::mat4 identity(1.0f);
+        roadInstances = pushInstances(&identity, 1);
+        buildingInstances = pushInstances(city.buildingModels.data(), city.buildingModels.size());
+        darkWindowInstances = pushInstances(city.darkWindowModels.data(), city.darkWindowModels.size());
+        litWindowInstances = pushInstances(city.litWindowModels.data(), city.litWindowModels.size());
+        postInstances = pushInstances(city.streetlightPostModels.data(), city.streetlightPostModels.size());
+        hoodInstances = pushInstances(city.streetlightHoodModels.data(), city.streetlightHoodModels.size());
+        lampInstances = pushInstances(city.streetlightLampModels.data(), city.streetlightLampModels.size());
+        carInstance = pushInstances(&carModel, 1);
+        moonInstance = pushInstances(&moonModel, 1);
+
+        // Frame uniforms shared by the depth, Phong and emission shaders
+        shadows.collectTimings();
+        shadows.update(view, glm::radians(fov), aspect);
+        FrameUniforms frame = FrameUniforms();
+        frame.projection = projection;
+        frame.view = view;
+        for (int i = 0; i < NUM_CASCADES; ++i) {
+            frame.lightSpaceMatrices[i] = shadows.cascades[i].lightSpace;
+            // zero splits make every fragment fall outside the cascades, i.e. unshadowed
+            frame.cascadeSplits[i] = shadows.enabled ? shadows.cascades[i].splitFar : 0.0f;
+        }
+        frame.viewPos = glm::vec4(cameraPos, 1.0f);
+        frame.dirLightDir = glm::vec4(MOON_LIGHT_DIR, 0.0f);
+        frame.dirLightColor = glm::vec4(0.6f, 0.6f, 0.7f, 1.0f);
+        frame.fogColor = glm::vec4(0.05f, 0.05f, 0.1f, 1.0f);
+        frame.ambientStrength = 0.3f;
+        frame.specularStrength = 1.0f;
+        frame.fogDensity = 0.02f;
+        frame.numPointLights = (int)city.pointLightPositions.size();
+        for (int i = 0; i < frame.numPointLights; ++i) {
+            frame.pointLights[i].position = glm::vec4(city.pointLightPositions[i], 1.0f);
+            frame.pointLights[i].color = glm::vec4(1.0f, 0.7f, 0.3f, 1.0f);
+            frame.pointLights[i].attenuation = glm::vec4(1.0f, 0.07f, 0.017f, 0.0f);
         }
+        RingSlice frameBlock = ring.pushUniforms(&frame, sizeof(frame));
+        glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, frameBlock.buffer, frameBlock.offset, frameBlock.size);
 
-        // Draw the road
-        glUniform1i(glGetUniformLocation(phongShader, "shininess"), 256);
-        glUniform3f(glGetUniformLocation(phongShader, "objectColor"), 0.15f, 0.15f, 0.15f);
-        glm::mat4 model = glm::mat4(1.0f);
-        glUniformMatrix4fv(glGetUniformLocation(phongShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        glBindVertexArray(roadVAO);
-        glDrawArrays(GL_TRIANGLES, 0, roadVertices.size()/6);
-
-        // Draw the buildings and streetlights
-        glBindVertexArray(cubeVAO);
-        glUniform1i(glGetUniformLocation(phongShader, "shininess"), 32);
-        glUniform3f(glGetUniformLocation(phongShader, "objectColor"), 0.2f, 0.2f, 0.25f);
-        for(const auto& m:buildingModels) { glUniformMatrix4fv(glGetUniformLocation(phongShader,"model"),1,GL_FALSE,glm::value_ptr(m)); glDrawArrays(GL_TRIANGLES,0,36); }
-        glUniform3f(glGetUniformLocation(phongShader, "objectColor"), 0.05f, 0.05f, 0.05f);
-        for(const auto& m:darkWindowModels) { glUniformMatrix4fv(glGetUniformLocation(phongShader,"model"),1,GL_FALSE,glm::value_ptr(m)); glDrawArrays(GL_TRIANGLES,0,36); }
-        glUniform3f(glGetUniformLocation(phongShader, "objectColor"), 0.4f, 0.4f, 0.4f);
-        for(const auto& m:streetlightPostModels) { glUniformMatrix4fv(glGetUniformLocation(phongShader,"model"),1,GL_FALSE,glm::value_ptr(m)); glDrawArrays(GL_TRIANGLES,0,36); }
-        for(const auto& m:streetlightHoodModels) { glUniformMatrix4fv(glGetUniformLocation(phongShader,"model"),1,GL_FALSE,glm::value_ptr(m)); glDrawArrays(GL_TRIANGLES,0,36); }
-
-        // Draw the car
-        glm::mat4 carRotation = glm::inverse(glm::lookAt(glm::vec3(0.0f), carTangent, glm::vec3(0.0f, 1.0f, 0.0f)));
-        model = glm::translate(glm::mat4(1.0f), carPos + glm::vec3(0, -0.2f, 0));
-        model = model * carRotation;
-        model = glm::rotate(model, glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        model = glm::scale(model, glm::vec3(CAR_SCALE_FACTOR));
-        glUniformMatrix4fv(glGetUniformLocation(phongShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniform3f(glGetUniformLocation(phongShader, "objectColor"), 0.1f, 0.25f, 0.6f);
-        glUniform1i(glGetUniformLocation(phongShader, "shininess"), 512);
-        glBindVertexArray(carVAO);
-        glDrawArrays(GL_TRIANGLES, 0, carVertices.size()/6);
-
-        // Set uniforms for the Emission (glowing) shader
-        glUseProgram(emissionShader);
-        glUniformMatrix4fv(glGetUniformLocation(emissionShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(emissionShader, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        // Shadow pass: only the near cascade and invalidated cached cascades are redrawn
+        glUseProgram(depthShader);
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(2.0f, 4.0f);
+        for (int i = 0; i < NUM_CASCADES && shadows.enabled; ++i) {
+            if (!shadows.cascades[i].renderThisFrame) continue;
+            shadows.beginCascade(i);
+            drawStaticScene(i);
+            if (!shadows.cascades[i].cached) drawCar(i);
+            shadows.endCascade(i);
+        }
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        int fbWidth = bench.width, fbHeight = bench.height;
+        if (!bench.enabled) glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        glBindFramebuffer(GL_FRAMEBUFFER, benchTarget.fbo);
+        glViewport(0, 0, fbWidth, fbHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // Draw the road, buildings, streetlights and car
+        glUseProgram(phongShader);
+        shadows.bind(0);
+        drawStaticScene(0);
+        drawCar(0);
 
         // Draw glowing objects
-        glUniform3f(glGetUniformLocation(emissionShader, "objectColor"), 1.0f, 0.9f, 0.7f);
-        for(const auto& m:litWindowModels) { glUniformMatrix4fv(glGetUniformLocation(emissionShader,"model"),1,GL_FALSE,glm::value_ptr(m)); glDrawArrays(GL_TRIANGLES,0,36); }
-        glUniform3f(glGetUniformLocation(emissionShader, "objectColor"), 1.0f, 0.7f, 0.3f);
-        for(const auto& m:streetlightLampModels) { glUniformMatrix4fv(glGetUniformLocation(emissionShader,"model"),1,GL_FALSE,glm::value_ptr(m)); glDrawArrays(GL_TRIANGLES,0,36); }
-        glm::mat4 moonModel = glm::translate(glm::mat4(1.0f), glm::vec3(20.0f, 50.0f, 20.0f));
-        moonModel = glm::scale(moonModel, glm::vec3(5.0f));
-        glUniformMatrix4fv(glGetUniformLocation(emissionShader, "model"), 1, GL_FALSE, glm::value_ptr(moonModel));
-        glUniform3f(glGetUniformLocation(emissionShader, "objectColor"), 0.9f, 0.9f, 1.0f);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        glUseProgram(emissionShader);
+        drawInstances(cubeVAO, 36, litWindowInstances, glm::vec3(1.0f, 0.9f, 0.7f), 0, 0);
+        drawInstances(cubeVAO, 36, lampInstances, glm::vec3(1.0f, 0.7f, 0.3f), 0, 0);
+        drawInstances(cubeVAO, 36, moonInstance, glm::vec3(0.9f, 0.9f, 1.0f), 0, 0);
+        ring.endFrame();
+
+        // Benchmark frames end when the GPU is done, not at buffer swap
+        if (bench.enabled) {
+            glFinish();
+            if (benchFrame >= 0) {
+                BenchSample sample = { (glfwGetTime() - frameStart) * 1000.0, renderCounters().drawCalls, renderCounters().triangles };
+                benchResult.samples.push_back(sample);
+            }
+            frameIndex++;
+        }
+
+        // Report shadow and upload cost breakdown
+        if (!bench.enabled && glfwGetTime() - lastStatsTime > STATS_INTERVAL) {
+            shadows.printStats(std::cout);
+            ring.printStats(std::cout);
+            lastStatsTime = glfwGetTime();
+        }
 
         // Swap buffers and poll events
-        glfwSwapBuffers(window);
+        if (!bench.enabled) glfwSwapBuffers(window);
         glfwPollEvents();
+
+        // Log load milestones
+        if (!firstFramePresented) {
+            firstFramePresented = true;
+            std::cout << "Time to first frame: " << millisecondsSince(startTime) << " ms" << std::endl;
+        }
+        if (!fullyLoaded && !roadJob.valid() && !cityJob.valid() && !carJob.valid() && uploads.idle()) {
+            fullyLoaded = true;
+            std::cout << "Time to fully loaded: " << millisecondsSince(startTime) << " ms ("
+                      << uploads.bytesUploaded() / 1024 << " KB uploaded over " << uploads.framesUsed() << " frames)" << std::endl;
+        }
+    }
+    shadows.printStats(std::cout);
+    ring.printStats(std::cout);
+    if (bench.enabled) {
+        benchResult.gpuBytes = sizeof(cubeVertices) + roadMesh.bytes + carMesh.bytes + ring.bytes()
+                             + (size_t)SHADOW_MAP_SIZE * SHADOW_MAP_SIZE * NUM_CASCADES * 4
+                             + (size_t)bench.width * bench.height * 8;
+        benchResult.sceneBytes = (city.buildingModels.size() + city.darkWindowModels.size() + city.litWindowModels.size()
+                               + city.streetlightPostModels.size() + city.streetlightLampModels.size() + city.streetlightHoodModels.size()) * sizeof(glm::mat4)
+                               + city.pointLightPositions.size() * sizeof(glm::vec3);
+        reportBench(bench, benchResult, city.litWindowModels.size(), city.darkWindowModels.size(), city.pointLightPositions.size());
     }
 
     // Cleanup resources
-    glDeleteVertexArrays(1, &roadVAO); glDeleteVertexArrays(1, &cubeVAO); glDeleteVertexArrays(1, &carVAO);
-    glDeleteBuffers(1, &roadVBO); glDeleteBuffers(1, &cubeVBO); glDeleteBuffers(1, &carVBO);
-    glDeleteProgram(phongShader); glDeleteProgram(emissionShader);
+    roadMesh.destroy(); carMesh.destroy();
+    glDeleteVertexArrays(1, &cubeVAO);
+    glDeleteBuffers(1, &cubeVBO);
+    glDeleteProgram(phongShader); glDeleteProgram(emissionShader); glDeleteProgram(depthShader);
+    shadows.destroy();
+    ring.destroy();
+    benchTarget.destroy();
     glfwTerminate();
     return 0;
 }
@@ -349,6 +526,12 @@ GLuint compileShader(const char* vertexSource, const char* fragmentSource) {
     glDeleteShader(vertexShader); glDeleteShader(fragmentShader);
     return shaderProgram;
 }
+void bindUniformBlocks(GLuint shader) {
+    GLuint frameIndex = glGetUniformBlockIndex(shader, "FrameData");
+    if (frameIndex != GL_INVALID_INDEX) glUniformBlockBinding(shader, frameIndex, FRAME_DATA_BINDING);
+    GLuint drawIndex = glGetUniformBlockIndex(shader, "DrawData");
+    if (drawIndex != GL_INVALID_INDEX) glUniformBlockBinding(shader, drawIndex, DRAW_DATA_BINDING);
+}
 glm::vec3 getBezierPoint(float t, const std::vector<glm::vec3>& controlPoints) {
     float u = 1.0f-t; float tt = t*t; float uu = u*u; float uuu=uu*u; float ttt=tt*t;
     glm::vec3 p = uuu * controlPoints[0]; p += 3*uu*t*controlPoints[1]; p += 3*u*tt*controlPoints[2]; p += ttt*controlPoints[3];
@@ -362,4 +545,87 @@ glm::vec3 getBezierTangent(float t, const std::vector<glm::vec3>& controlPoints)
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
 }
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+std::vector<float> tessellateRoad(const std::vector<glm::vec3>& roadControlPoints) {
+    std::vector<float> roadVertices;
+    for (int i = 0; i < 100; ++i) {
+        float t1=(float)i/100, t2=(float)(i+1)/100;
+        glm::vec3 p1=getBezierPoint(t1,roadControlPoints), p2=getBezierPoint(t2,roadControlPoints);
+        glm::vec3 n1=glm::normalize(glm::cross(glm::normalize(getBezierTangent(t1,roadControlPoints)), glm::vec3(0,1,0)));
+        glm::vec3 n2=glm::normalize(glm::cross(glm::normalize(getBezierTangent(t2,roadControlPoints)), glm::vec3(0,1,0)));
+        glm::vec3 v1=p1-n1*5.0f, v2=p1+n1*5.0f, v3=p2-n2*5.0f, v4=p2+n2*5.0f;
+        roadVertices.insert(roadVertices.end(),{v1.x,v1.y,v1.z,0,1,0, v2.x,v2.y,v2.z,0,1,0, v3.x,v3.y,v3.z,0,1,0});
+        roadVertices.insert(roadVertices.end(),{v2.x,v2.y,v2.z,0,1,0, v4.x,v4.y,v4.z,0,1,0, v3.x,v3.y,v3.z,0,1,0});
+    }
+    return roadVertices;
+}
+CityLayout generateCity(const std::vector<glm::vec3>& roadControlPoints, SceneConfig config) {
+    CityLayout city;
+    // 20 slots line the road; extra buildings fill further rows behind them
+    const int slotsPerRow = 20;
+    float windowStep = 3.0f / std::sqrt(config.windowDensity);
+    for(int i=0;i<config.buildings;++i){
+        int slot=i%slotsPerRow, row=i/slotsPerRow;
+        float t=(float)slot/slotsPerRow;
+        glm::vec3 pos=getBezierPoint(t,roadControlPoints);
+        glm::vec3 tangent=glm::normalize(getBezierTangent(t,roadControlPoints));
+        glm::vec3 n=glm::normalize(glm::cross(tangent,glm::vec3(0,1,0)));
+        float side=(i%2==0)?1.0f:-1.0f;
+        float h=10.0f+(std::rand()%10)*4.0f, w=4.0f+(std::rand()%5), offset=5.0f+w+row*12.0f;
+        glm::mat4 model=glm::translate(glm::mat4(1.0f),pos+n*side*offset+glm::vec3(0,h/2.0f,0));
+        model=glm::rotate(model,(float)atan2(tangent.x,tangent.z),glm::vec3(0,1,0));
+        model=glm::scale(model,glm::vec3(w,h,w));
+        city.buildingModels.push_back(model);
+        for(float y=2.0f;y<h-2.0f;y+=windowStep){
+            for(float x=-w/2.0f+1.5f;x<w/2.0f-1.5f;x+=windowStep){
+                glm::mat4 winModel=glm::translate(model,glm::vec3(x/w,(y-h/2.0f)/h,0.51f));
+                winModel=glm::scale(winModel,glm::vec3(1.5f/w,1.5f/h,0.1f));
+                if(std::rand()%3==0)city.litWindowModels.push_back(winModel);else city.darkWindowModels.push_back(winModel);
+            }
+        }
+    }
+    // Streetlights alternate sides along the road, independent of the buildings.
+    // The default 7 sit 3 slots apart, as before; more are squeezed closer.
+    float lightStep = 3.0f / slotsPerRow;
+    if (config.lights > 1) lightStep = std::min(lightStep, 0.95f / (config.lights - 1));
+    for(int k=0;k<config.lights;++k){
+        float t=k*lightStep;
+        glm::vec3 pos=getBezierPoint(t,roadControlPoints);
+        glm::vec3 tangent=glm::normalize(getBezierTangent(t,roadControlPoints));
+        glm::vec3 n=glm::normalize(glm::cross(tangent,glm::vec3(0,1,0)));
+        float side=(k%2==0)?1.0f:-1.0f;
+        glm::vec3 pPos=pos+n*side*(5.0f+1.0f);
+        glm::mat4 pModel=glm::translate(glm::mat4(1.0f),pPos+glm::vec3(0,3.0f,0));
+        pModel=glm::scale(pModel,glm::vec3(0.2f,6.0f,0.2f));
+        city.streetlightPostModels.push_back(pModel);
+        glm::vec3 lPos=pPos+glm::vec3(0,6.5f,0);
+        city.pointLightPositions.push_back(lPos);
+        glm::mat4 lModel=glm::translate(glm::mat4(1.0f),lPos);
+        lModel=glm::scale(lModel,glm::vec3(0.5f));
+        city.streetlightLampModels.push_back(lModel);
+        glm::mat4 hModel=glm::translate(glm::mat4(1.0f),lPos+glm::vec3(0,0.3f,0));
+        hModel=glm::scale(hModel,glm::vec3(0.8f,0.1f,0.8f));
+        city.streetlightHoodModels.push_back(hModel);
+    }
+    return city;
+}
+std::vector<float> loadCarMesh(const char* path) {
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+    if(!tinyobj::LoadObj(&attrib,&shapes,&materials,&warn,&err,path)){throw std::runtime_error(warn+err);}
+    std::vector<float> carVertices;
+    for(const auto& shape:shapes){
+        for(const auto& index:shape.mesh.indices){
+            if(3*index.vertex_index+2<attrib.vertices.size()&&index.vertex_index>=0&&3*index.normal_index+2<attrib.normals.size()&&index.normal_index>=0){
+                carVertices.push_back(attrib.vertices[3*index.vertex_index+0]);carVertices.push_back(attrib.vertices[3*index.vertex_index+1]);carVertices.push_back(attrib.vertices[3*index.vertex_index+2]);
+                carVertices.push_back(attrib.normals[3*index.normal_index+0]);carVertices.push_back(attrib.normals[3*index.normal_index+1]);carVertices.push_back(attrib.normals[3*index.normal_index+2]);
+            }
+        }
+    }
+    return carVertices;
+}
 
@@ -0,0 +1,200 @@
+#ifndef ANIMATION_SHADOWS_H
+#define ANIMATION_SHADOWS_H
+
+// Cascaded shadow maps for the directional moonlight.
+// Cascade 0 follows the camera and is re-rendered every frame with the car.
+// The outer cascades only hold static geometry, so their depth is kept and
+// reused until the camera slice they must cover drifts out of the cached area.
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+const int NUM_CASCADES = 3;
+const int SHADOW_MAP_SIZE = 2048;
+const float SHADOW_CACHE_MARGIN = 1.5f;    // cached cascades cover this much more than the slice
+const float SHADOW_CASTER_DISTANCE = 100.0f; // how far towards the light casters may sit
+
+struct ShadowCascade {
+    float splitNear, splitFar;     // view-space depth range
+    bool cached;                   // keep depth between frames (static geometry only)
+    bool valid;
+    bool renderThisFrame;
+    glm::vec3 coverCenter;         // world-space sphere the current depth covers
+    float coverRadius;
+    glm::mat4 lightSpace;
+
+    // Cost breakdown
+    unsigned long renders, reuses, timedRenders;
+    double gpuMs, cpuMs;
+    GLuint query;
+    bool queryPending;
+};
+
+struct CascadedShadowMap {
+    GLuint fbo, depthArray;
+    bool enabled;
+    glm::vec3 lightDir;
+    ShadowCascade cascades[NUM_CASCADES];
+    double cpuStart;
+
+    // splits holds NUM_CASCADES+1 view depths, nearest first
+    void init(const float* splits, glm::vec3 dir) {
+        lightDir = glm::normalize(dir);
+        enabled = true;
+        glGenTextures(1, &depthArray);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, depthArray);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, NUM_CASCADES, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        float border[] = {1.0f, 1.0f, 1.0f, 1.0f};
+        glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthArray, 0, 0);
+        glDrawBuffer(GL_NONE); glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::cerr << "Shadow Framebuffer Incomplete" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        for (int i = 0; i < NUM_CASCADES; ++i) {
+            ShadowCascade& c = cascades[i];
+            c.splitNear = splits[i]; c.splitFar = splits[i+1];
+            c.cached = (i > 0);
+            c.valid = false; c.renderThisFrame = false;
+            c.coverCenter = glm::vec3(0.0f); c.coverRadius = 0.0f;
+            c.lightSpace = glm::mat4(1.0f);
+            c.renders = c.reuses = c.timedRenders = 0;
+            c.gpuMs = c.cpuMs = 0.0;
+            glGenQueries(1, &c.query);
+            c.queryPending = false;
+        }
+    }
+
+    // Decide which cascades need new depth this frame and build their light matrices
+    void update(const glm::mat4& view, float fovRadians, float aspect) {
+        glm::mat4 invView = glm::inverse(view);
+        for (int i = 0; i < NUM_CASCADES; ++i) {
+            ShadowCascade& c = cascades[i];
+            glm::vec3 center; float radius;
+            sliceBounds(invView, fovRadians, aspect, c.splitNear, c.splitFar, center, radius);
+
+            if (c.cached && c.valid && glm::distance(center, c.coverCenter) + radius <= c.coverRadius) {
+                c.renderThisFrame = false;
+                c.reuses++;
+                continue;
+            }
+            c.coverCenter = center;
+            c.coverRadius = c.cached ? radius * SHADOW_CACHE_MARGIN : radius;
+            c.lightSpace = lightMatrix(c.coverCenter, c.coverRadius);
+            c.renderThisFrame = true;
+            c.valid = true;
+        }
+    }
+
+    // Static geometry changed: drop every cached depth map
+    void invalidate() {
+        for (int i = 0; i < NUM_CASCADES; ++i) cascades[i].valid = false;
+    }
+
+    void beginCascade(int i) {
+        ShadowCascade& c = cascades[i];
+        cpuStart = glfwGetTime();
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthArray, 0, i);
+        glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        if (!c.queryPending) glBeginQuery(GL_TIME_ELAPSED, c.query);
+    }
+
+    void endCascade(int i) {
+        ShadowCascade& c = cascades[i];
+        if (!c.queryPending) { glEndQuery(GL_TIME_ELAPSED); c.queryPending = true; }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        c.renders++;
+        c.cpuMs += (glfwGetTime() - cpuStart) * 1000.0;
+    }
+
+    // Harvest finished GPU timer queries without stalling
+    void collectTimings() {
+        for (int i = 0; i < NUM_CASCADES; ++i) {
+            ShadowCascade& c = cascades[i];
+            if (!c.queryPending) continue;
+            GLint available = 0;
+            glGetQueryObjectiv(c.query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue;
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(c.query, GL_QUERY_RESULT, &ns);
+            c.gpuMs += ns / 1.0e6;
+            c.timedRenders++;
+            c.queryPending = false;
+        }
+    }
+
+    // Matrices and splits travel in the FrameData block; only the texture is bound here
+    void bind(int textureUnit) {
+        glActiveTexture(GL_TEXTURE0 + textureUnit);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, depthArray);
+    }
+
+    void printStats(std::ostream& out) const {
+        out << "Shadow cascades:" << std::endl;
+        for (int i = 0; i < NUM_CASCADES; ++i) {
+            const ShadowCascade& c = cascades[i];
+            unsigned long frames = c.renders + c.reuses;
+            out << "  [" << i << "] " << c.splitNear << "-" << c.splitFar << (c.cached ? " cached " : " dynamic")
+                << "  rendered " << c.renders << "  reused " << c.reuses
+                << " (" << (frames ? 100.0 * c.reuses / frames : 0.0) << "%)"
+                << "  gpu " << (c.timedRenders ? c.gpuMs / c.timedRenders : 0.0) << " ms/render"
+                << "  cpu " << (c.renders ? c.cpuMs / c.renders : 0.0) << " ms/render" << std::endl;
+        }
+    }
+
+    void destroy() {
+        for (int i = 0; i < NUM_CASCADES; ++i) glDeleteQueries(1, &cascades[i].query);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteTextures(1, &depthArray);
+    }
+
+private:
+    // Bounding sphere of the camera frustum between two view depths
+    static void sliceBounds(const glm::mat4& invView, float fov, float aspect, float zNear, float zFar, glm::vec3& center, float& radius) {
+        glm::vec3 corners[8];
+        int n = 0;
+        for (float d : {zNear, zFar}) {
+            float h = d * std::tan(fov * 0.5f), w = h * aspect;
+            for (float sy : {-1.0f, 1.0f}) for (float sx : {-1.0f, 1.0f})
+                corners[n++] = glm::vec3(invView * glm::vec4(sx * w, sy * h, -d, 1.0f));
+        }
+        center = glm::vec3(0.0f);
+        for (int i = 0; i < 8; ++i) center += corners[i];
+        center /= 8.0f;
+        radius = 0.0f;
+        for (int i = 0; i < 8; ++i) radius = std::max(radius, glm::distance(center, corners[i]));
+        radius = std::ceil(radius * 16.0f) / 16.0f; // keep the texel size stable across frames
+    }
+
+    // Orthographic light projection around a sphere, snapped to whole texels
+    glm::mat4 lightMatrix(glm::vec3 center, float radius) const {
+        glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), lightDir, glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::vec3 c = glm::vec3(lightView * glm::vec4(center, 1.0f));
+        float texel = 2.0f * radius / SHADOW_MAP_SIZE;
+        c.x = std::floor(c.x / texel) * texel;
+        c.y = std::floor(c.y / texel) * texel;
+        glm::mat4 proj = glm::ortho(c.x - radius, c.x + radius, c.y - radius, c.y + radius,
+                                    -c.z - radius - SHADOW_CASTER_DISTANCE, -c.z + radius);
+        return proj * lightView;
+    }
+};
+
+#endif
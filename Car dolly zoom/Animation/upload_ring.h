@@ -0,0 +1,148 @@
+#ifndef ANIMATION_UPLOAD_RING_H
+#define ANIMATION_UPLOAD_RING_H
+
+// Per-frame GPU upload ring.
+// One buffer is split into RING_FRAMES regions. Each frame bump-allocates from
+// its own region and fences it at the end, so the CPU only waits when it has
+// lapped the GPU. With ARB_buffer_storage the buffer is persistently mapped and
+// pushes are a plain memcpy; without it they fall back to glBufferSubData.
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <cassert>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+const int RING_FRAMES = 3;
+const size_t RING_REGION_BYTES = 4 * 1024 * 1024;
+
+// Where a push landed; bind with buffer + offset
+struct RingSlice {
+    GLuint buffer;
+    GLintptr offset;
+    GLsizeiptr size;
+};
+
+class UploadRing {
+public:
+    void init(size_t regionBytes = RING_REGION_BYTES) {
+        persistent = GLEW_ARB_buffer_storage != 0;
+        if (!persistent) std::cerr << "ARB_buffer_storage unavailable, upload ring falls back to glBufferSubData" << std::endl;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboAlign);
+        assert(uboAlign > 0 && (uboAlign & (uboAlign - 1)) == 0 && "push() rounds with power-of-two masks");
+        buf = 0; mapped = NULL;
+        frame = 0; head = 0;
+        frames = stalls = overflows = 0; stallMs = 0.0; peakBytes = 0;
+        for (int i = 0; i < RING_FRAMES; ++i) fences[i] = 0;
+        allocate(regionBytes);
+    }
+
+    // Move to the next region, waiting only if the GPU still reads it
+    void beginFrame() {
+        for (size_t i = 0; i < retired.size(); ++i) glDeleteBuffers(1, &retired[i]);
+        retired.clear();
+        frame = (frame + 1) % RING_FRAMES;
+        head = 0;
+        frames++;
+        GLsync fence = fences[frame];
+        if (!fence) return;
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            stalls++;
+            double start = glfwGetTime();
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+            stallMs += (glfwGetTime() - start) * 1000.0;
+        }
+        glDeleteSync(fence);
+        fences[frame] = 0;
+    }
+
+    // Copy data into this frame's region; alignment must be a power of two
+    RingSlice push(const void* data, size_t size, size_t alignment = 16) {
+        if (size == 0) {
+            RingSlice empty = { buf, (GLintptr)(frame * regionSize), 0 };
+            return empty;
+        }
+        size_t offset = (head + alignment - 1) & ~(alignment - 1);
+        if (offset + size > regionSize) {
+            grow(std::max(regionSize * 2, size * 2));
+            offset = 0;
+        }
+        size_t absolute = frame * regionSize + offset;
+        if (persistent) {
+            memcpy(mapped + absolute, data, size);
+        } else {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buf);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, absolute, size, data);
+        }
+        head = offset + size;
+        peakBytes = std::max(peakBytes, head);
+        RingSlice slice = { buf, (GLintptr)absolute, (GLsizeiptr)size };
+        return slice;
+    }
+
+    RingSlice pushUniforms(const void* data, size_t size) { return push(data, size, uboAlign); }
+
+    // Fence everything submitted from this frame's region
+    void endFrame() {
+        fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void printStats(std::ostream& out) const {
+        out << "Upload ring: " << (persistent ? "persistent" : "glBufferSubData") << ", " << RING_FRAMES << " x " << regionSize / 1024 << " KB"
+            << "  peak " << peakBytes / 1024 << " KB/frame"
+            << "  stalls " << stalls << "/" << frames << " (" << stallMs << " ms)"
+            << "  overflows " << overflows << std::endl;
+    }
+
+    size_t bytes() const { return regionSize * RING_FRAMES; }
+
+    void destroy() {
+        for (int i = 0; i < RING_FRAMES; ++i) if (fences[i]) glDeleteSync(fences[i]);
+        for (size_t i = 0; i < retired.size(); ++i) glDeleteBuffers(1, &retired[i]);
+        glDeleteBuffers(1, &buf);
+    }
+
+private:
+    // Regions are a whole number of UBO alignments so every region starts aligned
+    void allocate(size_t regionBytes) {
+        size_t align = std::max<size_t>(uboAlign, 16);
+        regionSize = (regionBytes + align - 1) & ~(align - 1);
+        glGenBuffers(1, &buf);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buf);
+        if (persistent) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_COPY_WRITE_BUFFER, regionSize * RING_FRAMES, NULL, flags);
+            mapped = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, regionSize * RING_FRAMES, flags);
+        } else {
+            glBufferData(GL_COPY_WRITE_BUFFER, regionSize * RING_FRAMES, NULL, GL_STREAM_DRAW);
+        }
+    }
+
+    // A region overflowed: switch to a bigger buffer. Slices already handed
+    // out this frame keep pointing at the old one, which is deleted next frame.
+    void grow(size_t regionBytes) {
+        overflows++;
+        for (int i = 0; i < RING_FRAMES; ++i) if (fences[i]) { glDeleteSync(fences[i]); fences[i] = 0; }
+        retired.push_back(buf);
+        allocate(regionBytes);
+        std::cout << "Upload ring overflow, regions grown to " << regionSize / 1024 << " KB" << std::endl;
+    }
+
+    GLuint buf;
+    std::vector<GLuint> retired;
+    char* mapped;
+    bool persistent;
+    GLint uboAlign;
+    size_t regionSize, head;
+    int frame;
+    GLsync fences[RING_FRAMES];
+
+    unsigned long frames, stalls, overflows;
+    double stallMs;
+    size_t peakBytes;
+};
+
+#endif
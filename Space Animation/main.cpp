@@ -1,8 +1,9 @@
 #include <GL/glut.h>
 #include <vector>
 #include <cmath>
-#include <cstdlib>
 #include <ctime>
+#include "particles.h"
+#include "transform2d.h"
 
 // ===================== CONSTANTS =====================
 #define PI 3.1415926535
@@ -27,9 +28,23 @@ const float COLOR_DARKGREY[]= {0.3f, 0.3f, 0.3f};
 const float COLOR_BLUE[]    = {0.2f, 0.4f, 1.0f};
 const float COLOR_ORANGE[]  = {0.9f, 0.3f, 0.1f};
 
-// ===================== HELPERS =====================
-struct Point { int x, y; };
+// ===================== PARTICLES =====================
+const float SIM_DT = 1.0f / 60.0f;
+const int FLAMES_PER_TICK = 40;
+const float FLAME_TRAIL = 0.15f;  // streak length in seconds of travel
+
+ParticlePool<4096> flames;
+StarField<200> stars;
+
+// Nozzle pose from the last drawn frame; emission happens in update()
+struct ExhaustPose {
+    Point left, right;
+    float angle_deg, scale;
+    bool valid;
+};
+ExhaustPose exhaust = {};
 
+// ===================== HELPERS =====================
 void drawFilledCircle(float cx, float cy, float r, const float color[3]) {
     glColor3fv(color);
     glBegin(GL_TRIANGLE_FAN);
@@ -42,79 +57,54 @@ void drawFilledCircle(float cx, float cy, float r, const float color[3]) {
 }
 
 void drawStars() {
-    glColor3fv(COLOR_WHITE);
     glBegin(GL_POINTS);
-    for (int i = 0; i < 200; i++) {
-        glVertex2i(rand() % 800, rand() % 600);
+    for (int i = 0; i < stars.size(); i++) {
+        float c = stars.brightness[i];
+        glColor3f(c, c, c);
+        glVertex2i(stars.x[i], stars.y[i]);
     }
     glEnd();
 }
 
-void drawFlames(Point baseL, Point baseR, float angle_deg, float scale) {
-    float flame_angle_rad = (angle_deg - 90.0f) * PI / 180.0f;
-    float dir_x = cos(flame_angle_rad);
-    float dir_y = sin(flame_angle_rad);
-
-    for (int i = 0; i < 15; i++) {
-        float t = (float)rand() / RAND_MAX;
-        Point base = {
-            (int)(baseL.x + t * (baseR.x - baseL.x)),
-            (int)(baseL.y + t * (baseR.y - baseL.y))
-        };
-
-        int flame_length = (10 + rand() % 20) * scale;
-        Point tip = {
-            (int)(base.x + flame_length * dir_x),
-            (int)(base.y + flame_length * dir_y)
-        };
-
-        glColor3f(1.0f, 0.5f + (rand() % 50) / 100.0f, 0.0f);
-        glBegin(GL_TRIANGLES);
-            glVertex2i(base.x - 2, base.y);
-            glVertex2i(base.x + 2, base.y);
-            glVertex2i(tip.x, tip.y);
-        glEnd();
+void drawFlames() {
+    // each particle is a short streak trailing back along its velocity
+    glBegin(GL_LINES);
+    for (size_t i = 0; i < flames.count; i++) {
+        glColor3f(flames.r[i], flames.g[i], flames.b[i]);
+        glVertex2f(flames.px[i], flames.py[i]);
+        glVertex2f(flames.px[i] - flames.vx[i] * FLAME_TRAIL, flames.py[i] - flames.vy[i] * FLAME_TRAIL);
     }
+    glEnd();
 }
 
-void drawRocket(Point translate, float angle_deg, float scale) {
-    float angle_rad = angle_deg * PI / 180.0f;
-    float cosA = cos(angle_rad), sinA = sin(angle_rad);
-
-    auto transform = [&](const std::vector<Point>& v_in) {
-        std::vector<Point> v_out;
-        for (const auto& v : v_in) {
-            v_out.push_back({
-                (int)(scale * (v.x * cosA - v.y * sinA)) + translate.x,
-                (int)(scale * (v.x * sinA + v.y * cosA)) + translate.y
-            });
-        }
-        return v_out;
-    };
+void drawPolygon(const Point* v, ShapePart part) {
+    glBegin(GL_POLYGON);
+    for (int i = part.first; i < part.first + part.count; i++) glVertex2i(v[i].x, v[i].y);
+    glEnd();
+}
 
-    // Rocket parts
-    auto nose      = transform({{0,40},{-15,10},{15,10}});
-    auto body      = transform({{-15,10},{15,10},{15,-30},{-15,-30}});
-    auto leftFin   = transform({{-15,0},{-15,-25},{-25,-35}});
-    auto rightFin  = transform({{15,0},{15,-25},{25,-35}});
-    auto exhaust   = transform({{-10,-30},{10,-30},{15,-40},{-15,-40}});
-    auto exhaustBase = transform({{-15,-40},{15,-40}});
+void drawRocket(Point translate, float angle_deg, float scale) {
+    // one batched transform into stack storage; parts index into it
+    Point v[ROCKET_VERTEX_COUNT];
+    transformPoints(ROCKET_X, ROCKET_Y, ROCKET_VERTEX_COUNT, Affine2D(translate, angle_deg, scale), v);
 
-    drawFlames(exhaustBase[0], exhaustBase[1], angle_deg, scale);
+    const Point* exhaustBase = v + ROCKET_EXHAUST_BASE.first;
+    exhaust = ExhaustPose{exhaustBase[0], exhaustBase[1], angle_deg, scale, true};
+    drawFlames();
 
     // Draw rocket parts filled
     glColor3fv(COLOR_RED);
-    glBegin(GL_POLYGON); for (auto&p: nose) glVertex2i(p.x,p.y); glEnd();
+    drawPolygon(v, ROCKET_NOSE);
 
     glColor3fv(COLOR_SILVER);
-    glBegin(GL_POLYGON); for (auto&p: body) glVertex2i(p.x,p.y); glEnd();
+    drawPolygon(v, ROCKET_BODY);
 
     glColor3fv(COLOR_RED);
-    glBegin(GL_POLYGON); for (auto&p: leftFin) glVertex2i(p.x,p.y); glEnd();
-    glBegin(GL_POLYGON); for (auto&p: rightFin) glVertex2i(p.x,p.y); glEnd();
+    drawPolygon(v, ROCKET_LEFT_FIN);
+    drawPolygon(v, ROCKET_RIGHT_FIN);
 
     glColor3fv(COLOR_DARKGREY);
-    glBegin(GL_POLYGON); for (auto&p: exhaust) glVertex2i(p.x,p.y); glEnd();
+    drawPolygon(v, ROCKET_EXHAUST);
 }
 
 // ===================== SCENE =====================
@@ -179,6 +169,12 @@ void update(int value) {
         cam_top    = 400 + 50*(1-zoom_t);
     }
 
+    // emit and integrate once per tick so redraws do not change flame density
+    if (exhaust.valid)
+        emitFlames(flames, exhaust.left.x, exhaust.left.y, exhaust.right.x, exhaust.right.y,
+                   exhaust.angle_deg, exhaust.scale, FLAMES_PER_TICK);
+    flames.update(SIM_DT);
+
     glutPostRedisplay();
     glutTimerFunc(16, update, 0); // ~60 FPS
 }
@@ -187,10 +183,15 @@ void update(int value) {
 // ===================== SETUP =====================
 void myInit() {
     glClearColor(0,0,0,1);
+
+    FastRng skyRng((uint32_t)time(0));
+    stars.generate(skyRng, 800, 600);
+    flames.rng = FastRng((uint32_t)time(0) ^ 0xA5A5A5A5u);
+    flames.setColors(1.0f, 0.9f, 0.0f,   // yellow at the nozzle
+                     1.0f, 0.1f, 0.0f);  // red at the tip
 }
 
 int main(int argc, char** argv) {
-    srand(time(0));
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
     glutInitWindowSize(800, 600);
@@ -0,0 +1,76 @@
+// Headless throughput check for particles.h.
+// Keeps the pool saturated with flame particles and times emit + update
+// against the 60 Hz frame budget.
+//
+//   g++ -O2 -msse2 particle_bench.cpp -o particle_bench && ./particle_bench
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "particles.h"
+
+const size_t POOL_SIZE = 131072;
+const int WARMUP_FRAMES = 120;
+const int FRAMES = 600;
+const float SIM_DT = 1.0f / 60.0f;
+const double FRAME_BUDGET_MS = 1000.0 / 60.0;
+
+static ParticlePool<POOL_SIZE> pool;
+
+// top the pool back up from a few exhaust nozzles spread over the screen
+void emitFrame() {
+    const int nozzles = 64;
+    int perNozzle = (int)((POOL_SIZE - pool.count) / nozzles);
+    for (int n = 0; n < nozzles; n++) {
+        float x = 12.5f * n, y = 300.0f;
+        emitFlames(pool, x - 15.0f, y, x + 15.0f, y, (float)(n * 5 % 360), 1.0f, perNozzle);
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : FRAMES;
+    pool.rng = FastRng(12345u);
+    pool.setColors(1.0f, 0.9f, 0.0f, 1.0f, 0.1f, 0.0f);
+    pool.accel_y = -20.0f;
+
+    for (int f = 0; f < WARMUP_FRAMES; f++) { emitFrame(); pool.update(SIM_DT); }
+
+    typedef std::chrono::steady_clock Clock;
+    double emitMs = 0.0, updateMs = 0.0, worstMs = 0.0;
+    size_t liveTotal = 0, minLive = POOL_SIZE;
+    float checksum = 0.0f;
+
+    for (int f = 0; f < frames; f++) {
+        Clock::time_point t0 = Clock::now();
+        emitFrame();
+        Clock::time_point t1 = Clock::now();
+        size_t live = pool.count;
+        pool.update(SIM_DT);
+        Clock::time_point t2 = Clock::now();
+
+        double e = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        double u = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        emitMs += e; updateMs += u;
+        if (e + u > worstMs) worstMs = e + u;
+        liveTotal += live;
+        if (live < minLive) minLive = live;
+        checksum += pool.px[f % pool.count] + pool.g[f % pool.count];
+    }
+
+    double avgLive = (double)liveTotal / frames;
+    double avgUpdate = updateMs / frames;
+    double avgFrame = (emitMs + updateMs) / frames;
+#ifdef PARTICLES_SSE
+    const char* path = "SSE2";
+#else
+    const char* path = "scalar";
+#endif
+
+    printf("particle_bench (%s, %d frames)\n", path, frames);
+    printf("  live particles   avg %.0f  min %zu  (pool %zu)\n", avgLive, minLive, POOL_SIZE);
+    printf("  update           %.3f ms/frame  %.2f ns/particle\n", avgUpdate, avgUpdate * 1e6 / avgLive);
+    printf("  emit + update    %.3f ms/frame  worst %.3f ms\n", avgFrame, worstMs);
+    printf("  budget           %.3f ms  -> %s\n", FRAME_BUDGET_MS, worstMs < FRAME_BUDGET_MS ? "OK" : "OVER");
+    printf("  checksum         %f\n", checksum);
+    return (minLive >= 100000 && worstMs < FRAME_BUDGET_MS) ? 0 : 1;
+}
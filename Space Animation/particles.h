@@ -0,0 +1,190 @@
+#ifndef SPACE_PARTICLES_H
+#define SPACE_PARTICLES_H
+
+// Particle pool shared by main.cpp and vorp.cpp.
+// No GL in here, so particle_bench.cpp can run it headless.
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLES_SSE 1
+#endif
+
+// ===================== RNG =====================
+// xorshift32: one state word per system, far cheaper than rand()
+struct FastRng {
+    uint32_t state;
+
+    explicit FastRng(uint32_t seed = 0x9E3779B9u) : state(seed ? seed : 1u) {}
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // [0, 1) from the top 24 bits
+    float uniform() { return (next() >> 8) * (1.0f / 16777216.0f); }
+    float range(float lo, float hi) { return lo + (hi - lo) * uniform(); }
+};
+
+// ===================== PARTICLE POOL =====================
+// Fixed-capacity structure of arrays. Live particles are packed in [0, count),
+// dead ones are swap-removed, so update() never touches a free slot.
+template <size_t Capacity>
+struct ParticlePool {
+    // round up to whole SIMD lanes so the vector loop needs no tail
+    static const size_t kStride = (Capacity + 3) & ~size_t(3);
+
+    alignas(16) float px[kStride], py[kStride];
+    alignas(16) float vx[kStride], vy[kStride];
+    alignas(16) float age[kStride], invLife[kStride];
+    alignas(16) float r[kStride], g[kStride], b[kStride];
+
+    // colour over life: lerp from start to end as age goes 0 -> life
+    float startColor[3];
+    float endColor[3];
+    float accel_x, accel_y;
+
+    size_t count;
+    FastRng rng;
+
+    ParticlePool() : accel_x(0.0f), accel_y(0.0f), count(0) {
+        for (size_t i = 0; i < kStride; i++) {
+            px[i] = py[i] = vx[i] = vy[i] = 0.0f;
+            age[i] = invLife[i] = 0.0f;
+            r[i] = g[i] = b[i] = 0.0f;
+        }
+        setColors(1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+    }
+
+    size_t capacity() const { return Capacity; }
+
+    void setColors(float r0, float g0, float b0, float r1, float g1, float b1) {
+        startColor[0] = r0; startColor[1] = g0; startColor[2] = b0;
+        endColor[0]   = r1; endColor[1]   = g1; endColor[2]   = b1;
+    }
+
+    // Returns false when the pool is full; the particle is dropped.
+    bool spawn(float x, float y, float vel_x, float vel_y, float life) {
+        if (count >= Capacity || life <= 0.0f) return false;
+        size_t i = count++;
+        px[i] = x;  py[i] = y;
+        vx[i] = vel_x; vy[i] = vel_y;
+        age[i] = 0.0f;
+        invLife[i] = 1.0f / life;
+        r[i] = startColor[0]; g[i] = startColor[1]; b[i] = startColor[2];
+        return true;
+    }
+
+    void clear() { count = 0; }
+
+    // Integrate, age and recolour every live particle, then drop expired ones.
+    void update(float dt) {
+        integrate(dt);
+        retire();
+    }
+
+private:
+    void integrate(float dt) {
+        const float dr = endColor[0] - startColor[0];
+        const float dg = endColor[1] - startColor[1];
+        const float db = endColor[2] - startColor[2];
+        const size_t n = (count + 3) & ~size_t(3);
+        size_t i = 0;
+
+#ifdef PARTICLES_SSE
+        const __m128 vdt = _mm_set1_ps(dt);
+        const __m128 vax = _mm_set1_ps(accel_x * dt);
+        const __m128 vay = _mm_set1_ps(accel_y * dt);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 r0 = _mm_set1_ps(startColor[0]), vdr = _mm_set1_ps(dr);
+        const __m128 g0 = _mm_set1_ps(startColor[1]), vdg = _mm_set1_ps(dg);
+        const __m128 b0 = _mm_set1_ps(startColor[2]), vdb = _mm_set1_ps(db);
+        for (; i < n; i += 4) {
+            __m128 x  = _mm_load_ps(px + i), y  = _mm_load_ps(py + i);
+            __m128 ux = _mm_load_ps(vx + i), uy = _mm_load_ps(vy + i);
+            ux = _mm_add_ps(ux, vax);
+            uy = _mm_add_ps(uy, vay);
+            x  = _mm_add_ps(x, _mm_mul_ps(ux, vdt));
+            y  = _mm_add_ps(y, _mm_mul_ps(uy, vdt));
+            _mm_store_ps(px + i, x);  _mm_store_ps(py + i, y);
+            _mm_store_ps(vx + i, ux); _mm_store_ps(vy + i, uy);
+
+            __m128 a = _mm_add_ps(_mm_load_ps(age + i), vdt);
+            _mm_store_ps(age + i, a);
+            __m128 t = _mm_min_ps(_mm_mul_ps(a, _mm_load_ps(invLife + i)), one);
+            _mm_store_ps(r + i, _mm_add_ps(r0, _mm_mul_ps(vdr, t)));
+            _mm_store_ps(g + i, _mm_add_ps(g0, _mm_mul_ps(vdg, t)));
+            _mm_store_ps(b + i, _mm_add_ps(b0, _mm_mul_ps(vdb, t)));
+        }
+#endif
+        for (; i < n; i++) {
+            vx[i] += accel_x * dt;
+            vy[i] += accel_y * dt;
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+            age[i] += dt;
+            float t = std::fmin(age[i] * invLife[i], 1.0f);
+            r[i] = startColor[0] + dr * t;
+            g[i] = startColor[1] + dg * t;
+            b[i] = startColor[2] + db * t;
+        }
+    }
+
+    void retire() {
+        size_t i = 0;
+        while (i < count) {
+            if (age[i] * invLife[i] < 1.0f) { i++; continue; }
+            size_t last = --count;
+            px[i] = px[last]; py[i] = py[last];
+            vx[i] = vx[last]; vy[i] = vy[last];
+            age[i] = age[last]; invLife[i] = invLife[last];
+            r[i] = r[last]; g[i] = g[last]; b[i] = b[last];
+        }
+    }
+};
+
+// ===================== EMITTERS =====================
+// Sprays particles from a random point on the segment base0 -> base1,
+// travelling along angle_deg. Speed and life are scaled like the rocket.
+template <size_t Capacity>
+void emitFlames(ParticlePool<Capacity>& pool, float base0_x, float base0_y,
+                float base1_x, float base1_y, float angle_deg, float scale, int n) {
+    const float rad = (angle_deg - 90.0f) * 3.1415926535f / 180.0f;
+    const float dir_x = std::cos(rad), dir_y = std::sin(rad);
+    for (int i = 0; i < n; i++) {
+        float t = pool.rng.uniform();
+        float x = base0_x + t * (base1_x - base0_x);
+        float y = base0_y + t * (base1_y - base0_y);
+        float speed = pool.rng.range(60.0f, 180.0f) * scale;
+        float spread = pool.rng.range(-0.15f, 0.15f);
+        float vel_x = speed * (dir_x - spread * dir_y);
+        float vel_y = speed * (dir_y + spread * dir_x);
+        if (!pool.spawn(x, y, vel_x, vel_y, pool.rng.range(0.08f, 0.2f))) return;
+    }
+}
+
+// ===================== STAR LAYER =====================
+// Generated once; brightness is fixed per star so the sky no longer flickers.
+template <int N>
+struct StarField {
+    int x[N], y[N];
+    float brightness[N];
+
+    void generate(FastRng& rng, int width, int height) {
+        for (int i = 0; i < N; i++) {
+            x[i] = (int)(rng.uniform() * width);
+            y[i] = (int)(rng.uniform() * height);
+            brightness[i] = rng.range(0.5f, 1.0f);
+        }
+    }
+
+    int size() const { return N; }
+};
+
+#endif
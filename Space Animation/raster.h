@@ -0,0 +1,110 @@
+#ifndef SPACE_RASTER_H
+#define SPACE_RASTER_H
+
+// Software raster primitives used by vorp.cpp.
+// Every pixel goes through a Plot functor (plot(x, y)), so the same code
+// drives glVertex2i in the demo and a plain buffer in raster_bench.cpp.
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "transform2d.h"
+
+struct ClipRect { float xmin, xmax, ymin, ymax; };
+
+// Liang Barsky Line clipping algorithm
+inline bool liangBarskyClip(Point &p0, Point &p1, float xmin, float xmax, float ymin, float ymax) {
+    float dx = p1.x - p0.x;
+    float dy = p1.y - p0.y;
+
+    float t0 = 0.0f, t1 = 1.0f;
+
+    float p[4] = {-dx, dx, -dy, dy};
+    float q[4] = {p0.x - xmin, xmax - p0.x, p0.y - ymin, ymax - p0.y};
+
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0) {
+            if (q[i] < 0) return false; // Line parallel & outside
+        } else {
+            float r = q[i] / p[i];
+            if (p[i] < 0) t0 = std::max(t0, r);
+            else t1 = std::min(t1, r);
+        }
+    }
+
+    if (t0 > t1) return false; // No visible part
+
+    Point new_p0 = {int(p0.x + t0 * dx), int(p0.y + t0 * dy)};
+    Point new_p1 = {int(p0.x + t1 * dx), int(p0.y + t1 * dy)};
+    p0 = new_p0; p1 = new_p1;
+    return true;
+}
+
+// Bresenham's line drawing algorithm, clipped to the window
+template <class Plot>
+void rasterLine(Point p0, Point p1, const ClipRect& clip, Plot& plot) {
+    if (!liangBarskyClip(p0, p1, clip.xmin, clip.xmax, clip.ymin, clip.ymax))
+        return;
+
+    int dx = abs(p1.x - p0.x), sx = (p0.x < p1.x ? 1 : -1);
+    int dy = -abs(p1.y - p0.y), sy = (p0.y < p1.y ? 1 : -1);
+    int err = dx + dy;
+
+    while (true) {
+        plot(p0.x, p0.y);
+        if (p0.x == p1.x && p0.y == p1.y) break;
+        int e2 = 2*err;
+        if (e2 >= dy) { err += dy; p0.x += sx; }
+        if (e2 <= dx) { err += dx; p0.y += sy; }
+    }
+}
+
+// center point circle drawing (unclipped, like the GL version)
+template <class Plot>
+void rasterCircleOutline(int cx, int cy, int r, Plot& plot) {
+    int x = 0, y = r;
+    int d = 1 - r;
+    while(y >= x) {
+        plot(cx + x, cy + y); plot(cx - x, cy + y);
+        plot(cx + x, cy - y); plot(cx - x, cy - y);
+        plot(cx + y, cy + x); plot(cx - y, cy + x);
+        plot(cx + y, cy - x); plot(cx - y, cy - x);
+        x++;
+        if(d < 0) d += 2*x + 1;
+        else { y--; d += 2*(x - y) + 1; }
+    }
+}
+
+// Scan line Fill
+template <class Plot>
+void rasterFillPolygon(const Point* polygon, int n, const ClipRect& clip, Plot& plot) {
+    int minY = polygon[0].y, maxY = polygon[0].y;
+    for(int i=0;i<n;i++){ minY = std::min(minY, polygon[i].y); maxY = std::max(maxY, polygon[i].y); }
+
+    for(int y = minY; y <= maxY; y++){
+        std::vector<int> intersections;
+        for(int i=0;i<n;i++){
+            Point a = polygon[i], b = polygon[(i+1)%n];
+            if(a.y == b.y) continue;
+            if(y < std::min(a.y,b.y) || y > std::max(a.y,b.y)) continue;
+            int x = a.x + (y - a.y)*(b.x - a.x)/(b.y - a.y);
+            intersections.push_back(x);
+        }
+        std::sort(intersections.begin(), intersections.end());
+        for(size_t i=0;i+1<intersections.size();i+=2){
+            rasterLine({intersections[i], y},{intersections[i+1],y}, clip, plot);
+        }
+    }
+}
+
+//Scan line fill
+template <class Plot>
+void rasterFilledCircle(int cx, int cy, int r, const ClipRect& clip, Plot& plot){
+    for(int y=-r;y<=r;y++){
+        int dx = (int)sqrt(r*r - y*y);
+        rasterLine({cx-dx, cy+y},{cx+dx, cy+y}, clip, plot);
+    }
+}
+
+#endif
@@ -0,0 +1,311 @@
+// Headless benchmark and pixel regression for the raster primitives in raster.h.
+// Each case draws deterministic inputs into a 1-bit canvas, reports ns/pixel
+// and primitives/s, and compares the canvas with golden/<case>.pbm. Cases
+// whose canvas coverage falls outside MIN_COVERAGE..MAX_COVERAGE fail too.
+// Before that, the SIMD paths of the transform2d.h kernels are checked
+// against their scalar tails.
+//
+//   g++ -O2 raster_bench.cpp -o raster_bench
+//   ./raster_bench                    compare against golden images
+//   ./raster_bench --update-golden    rewrite them after an intended change
+//   ./raster_bench --golden-dir DIR   read/write goldens somewhere else
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "particles.h"
+#include "raster.h"
+
+const int CANVAS_W = 256;
+const int CANVAS_H = 256;
+const double MIN_CASE_SECONDS = 0.2;
+// a golden that is nearly blank or nearly full cannot show a 1 px change
+const double MIN_COVERAGE = 0.02;
+const double MAX_COVERAGE = 0.5;
+
+// ===================== CANVAS =====================
+struct BufferPlot {
+    std::vector<uint8_t> px;
+    long count;
+
+    BufferPlot() : px(CANVAS_W * CANVAS_H), count(0) {}
+
+    void clear() { std::fill(px.begin(), px.end(), 0); count = 0; }
+
+    // count every pixel emitted; only keep those that land on the canvas
+    void operator()(int x, int y) {
+        count++;
+        if ((unsigned)x < (unsigned)CANVAS_W && (unsigned)y < (unsigned)CANVAS_H)
+            px[y * CANVAS_W + x] = 1;
+    }
+};
+
+const ClipRect CANVAS_CLIP = {0, CANVAS_W - 1, 0, CANVAS_H - 1};
+
+// ===================== INPUTS =====================
+// Everything is generated up front from fixed seeds so goldens are stable.
+struct Circle { int cx, cy, r; };
+
+struct Scene {
+    std::vector<Point> lineEnds;        // pairs
+    std::vector<Circle> circles;
+    std::vector<Point> polyVerts;       // polygons packed back to back
+    std::vector<int> polyCounts;
+};
+
+int randInt(FastRng& rng, int lo, int hi) { return lo + (int)(rng.uniform() * (hi - lo + 1)); }
+
+void addRandomLines(Scene& s, FastRng& rng, int n) {
+    for (int i = 0; i < n; i++) {
+        s.lineEnds.push_back({randInt(rng, -64, CANVAS_W + 64), randInt(rng, -64, CANVAS_H + 64)});
+        s.lineEnds.push_back({randInt(rng, -64, CANVAS_W + 64), randInt(rng, -64, CANVAS_H + 64)});
+    }
+}
+
+void addSteepLines(Scene& s, FastRng& rng, int n) {
+    for (int i = 0; i < n; i++) {
+        int x = randInt(rng, 0, CANVAS_W - 1);
+        s.lineEnds.push_back({x, randInt(rng, -32, 16)});
+        s.lineEnds.push_back({x + randInt(rng, -3, 3), randInt(rng, CANVAS_H - 16, CANVAS_H + 32)});
+    }
+}
+
+// endpoints far outside opposite edges, so only the clipped middle is drawn;
+// every fourth line stays entirely outside and must produce nothing
+void addClippedLines(Scene& s, FastRng& rng, int n) {
+    for (int i = 0; i < n; i++) {
+        Point a, b;
+        if (i % 4 == 3) {
+            a = {randInt(rng, -500, -1), randInt(rng, -500, CANVAS_H + 500)};
+            b = {randInt(rng, -500, -1), randInt(rng, -500, CANVAS_H + 500)};
+        } else if (i % 2 == 0) {
+            a = {randInt(rng, -500, -100), randInt(rng, 0, CANVAS_H - 1)};
+            b = {randInt(rng, CANVAS_W + 100, CANVAS_W + 500), randInt(rng, 0, CANVAS_H - 1)};
+        } else {
+            a = {randInt(rng, 0, CANVAS_W - 1), randInt(rng, -500, -100)};
+            b = {randInt(rng, 0, CANVAS_W - 1), randInt(rng, CANVAS_H + 100, CANVAS_H + 500)};
+        }
+        s.lineEnds.push_back(a);
+        s.lineEnds.push_back(b);
+    }
+}
+
+void addCircles(Scene& s, FastRng& rng, int n, int rmin, int rmax) {
+    for (int i = 0; i < n; i++)
+        s.circles.push_back({randInt(rng, 0, CANVAS_W - 1), randInt(rng, 0, CANVAS_H - 1), randInt(rng, rmin, rmax)});
+}
+
+// huge circles centred off-canvas whose edge reaches 'depth' pixels in from
+// one of the four sides, so only a gently curved arc crosses the canvas
+void addEdgeCircles(Scene& s, FastRng& rng, int n, int r, int minDepth, int maxDepth) {
+    for (int i = 0; i < n; i++) {
+        int depth = randInt(rng, minDepth, maxDepth);
+        int along = randInt(rng, 0, CANVAS_W - 1);
+        switch (i % 4) {
+            case 0:  s.circles.push_back({depth - r, along, r}); break;
+            case 1:  s.circles.push_back({CANVAS_W - 1 - depth + r, along, r}); break;
+            case 2:  s.circles.push_back({along, depth - r, r}); break;
+            default: s.circles.push_back({along, CANVAS_H - 1 - depth + r, r}); break;
+        }
+    }
+}
+
+// star shapes: alternating inner/outer radius, always concave
+void addStarPolygons(Scene& s, FastRng& rng, int n, int xmin, int xmax, float outerMin, float outerMax) {
+    for (int i = 0; i < n; i++) {
+        int spikes = randInt(rng, 5, 12);
+        float cx = randInt(rng, xmin, xmax), cy = randInt(rng, 0, CANVAS_H - 1);
+        float outer = rng.range(outerMin, outerMax), inner = outer * rng.range(0.2f, 0.5f);
+        for (int k = 0; k < spikes * 2; k++) {
+            float a = k * 3.1415926535f / spikes;
+            float r = (k % 2) ? inner : outer;
+            s.polyVerts.push_back({(int)(cx + r * std::cos(a)), (int)(cy + r * std::sin(a))});
+        }
+        s.polyCounts.push_back(spikes * 2);
+    }
+}
+
+// ===================== CASES =====================
+enum Primitive { LINE, CIRCLE_OUTLINE, FILL_POLYGON, FILL_CIRCLE };
+
+struct Case {
+    const char* name;
+    Primitive prim;
+    Scene scene;
+};
+
+long primitiveCount(const Case& c) {
+    switch (c.prim) {
+        case LINE:         return (long)c.scene.lineEnds.size() / 2;
+        case FILL_POLYGON: return (long)c.scene.polyCounts.size();
+        default:           return (long)c.scene.circles.size();
+    }
+}
+
+void render(const Case& c, BufferPlot& plot) {
+    const Scene& s = c.scene;
+    switch (c.prim) {
+    case LINE:
+        for (size_t i = 0; i + 1 < s.lineEnds.size(); i += 2)
+            rasterLine(s.lineEnds[i], s.lineEnds[i + 1], CANVAS_CLIP, plot);
+        break;
+    case CIRCLE_OUTLINE:
+        for (const Circle& ci : s.circles) rasterCircleOutline(ci.cx, ci.cy, ci.r, plot);
+        break;
+    case FILL_POLYGON: {
+        const Point* v = s.polyVerts.data();
+        for (int n : s.polyCounts) { rasterFillPolygon(v, n, CANVAS_CLIP, plot); v += n; }
+        break;
+    }
+    case FILL_CIRCLE:
+        for (const Circle& ci : s.circles) rasterFilledCircle(ci.cx, ci.cy, ci.r, CANVAS_CLIP, plot);
+        break;
+    }
+}
+
+std::vector<Case> buildCases() {
+    std::vector<Case> cases;
+    FastRng rng(0xC0FFEEu);
+    Case c;
+
+    // counts are kept low so each golden stays sparse enough to show a 1 px change
+    c = Case{"line_random", LINE, Scene()};           addRandomLines(c.scene, rng, 60);         cases.push_back(c);
+    c = Case{"line_steep", LINE, Scene()};            addSteepLines(c.scene, rng, 40);          cases.push_back(c);
+    c = Case{"line_clipped", LINE, Scene()};          addClippedLines(c.scene, rng, 60);        cases.push_back(c);
+    c = Case{"circle_random", CIRCLE_OUTLINE, Scene()}; addCircles(c.scene, rng, 40, 1, 100);   cases.push_back(c);
+    c = Case{"circle_huge", CIRCLE_OUTLINE, Scene()}; addEdgeCircles(c.scene, rng, 24, 20000, 0, CANVAS_W - 1); cases.push_back(c);
+    c = Case{"polygon_concave", FILL_POLYGON, Scene()}; addStarPolygons(c.scene, rng, 12, 0, CANVAS_W - 1, 10.0f, 40.0f); cases.push_back(c);
+    c = Case{"polygon_clipped", FILL_POLYGON, Scene()}; addStarPolygons(c.scene, rng, 6, -60, 20, 30.0f, 90.0f); cases.push_back(c);
+    c = Case{"fill_circle_random", FILL_CIRCLE, Scene()}; addCircles(c.scene, rng, 15, 2, 30); cases.push_back(c);
+    c = Case{"fill_circle_huge", FILL_CIRCLE, Scene()}; addEdgeCircles(c.scene, rng, 4, 4000, 8, 24); cases.push_back(c);
+    return cases;
+}
+
+// ===================== TRANSFORM KERNELS =====================
+// One call over the whole rocket table runs the SIMD loop; calling the
+// kernel one vertex at a time only ever runs the scalar tail. Both must agree.
+const int TRANSFORM_POSES = 100000;
+
+long checkTransforms() {
+    FastRng rng(0xBADA55u);
+    long mismatches = 0;
+    Point simd[ROCKET_VERTEX_COUNT], scalar[ROCKET_VERTEX_COUNT];
+    SubPoint simdFixed[ROCKET_VERTEX_COUNT], scalarFixed[ROCKET_VERTEX_COUNT];
+    for (int p = 0; p < TRANSFORM_POSES; p++) {
+        // translations on both sides of zero, like a fleet spread around the camera
+        Point t = {randInt(rng, -100000, 100000), randInt(rng, -100000, 100000)};
+        Affine2D m(t, rng.range(-360.0f, 360.0f), rng.range(0.05f, 8.0f));
+        transformPoints(ROCKET_X, ROCKET_Y, ROCKET_VERTEX_COUNT, m, simd);
+        transformPointsFixed(ROCKET_X, ROCKET_Y, ROCKET_VERTEX_COUNT, m, simdFixed);
+        for (int i = 0; i < ROCKET_VERTEX_COUNT; i++) {
+            transformPoints(ROCKET_X + i, ROCKET_Y + i, 1, m, scalar + i);
+            transformPointsFixed(ROCKET_X + i, ROCKET_Y + i, 1, m, scalarFixed + i);
+            mismatches += simd[i].x != scalar[i].x || simd[i].y != scalar[i].y;
+            mismatches += simdFixed[i].x != scalarFixed[i].x || simdFixed[i].y != scalarFixed[i].y;
+        }
+    }
+    return mismatches;
+}
+
+// ===================== GOLDEN IMAGES =====================
+// Binary PBM (P4): 1 bit per pixel, rows padded to whole bytes.
+bool writePbm(const std::string& path, const std::vector<uint8_t>& px) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    fprintf(f, "P4\n%d %d\n", CANVAS_W, CANVAS_H);
+    std::vector<uint8_t> row((CANVAS_W + 7) / 8);
+    for (int y = 0; y < CANVAS_H; y++) {
+        std::fill(row.begin(), row.end(), 0);
+        for (int x = 0; x < CANVAS_W; x++)
+            if (px[y * CANVAS_W + x]) row[x / 8] |= 0x80 >> (x % 8);
+        fwrite(row.data(), 1, row.size(), f);
+    }
+    fclose(f);
+    return true;
+}
+
+bool readPbm(const std::string& path, std::vector<uint8_t>& px) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    int w = 0, h = 0;
+    bool ok = fscanf(f, "P4 %d %d", &w, &h) == 2 && fgetc(f) != EOF && w == CANVAS_W && h == CANVAS_H;
+    std::vector<uint8_t> row((CANVAS_W + 7) / 8);
+    px.assign(CANVAS_W * CANVAS_H, 0);
+    for (int y = 0; ok && y < CANVAS_H; y++) {
+        ok = fread(row.data(), 1, row.size(), f) == row.size();
+        for (int x = 0; ok && x < CANVAS_W; x++)
+            px[y * CANVAS_W + x] = (row[x / 8] >> (7 - x % 8)) & 1;
+    }
+    fclose(f);
+    return ok;
+}
+
+// ===================== MAIN =====================
+int main(int argc, char** argv) {
+    bool update = false;
+    std::string goldenDir = "golden";
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--update-golden")) update = true;
+        else if (!strcmp(argv[i], "--golden-dir") && i + 1 < argc) goldenDir = argv[++i];
+        else { fprintf(stderr, "usage: %s [--update-golden] [--golden-dir DIR]\n", argv[0]); return 2; }
+    }
+
+    long transformMismatches = checkTransforms();
+    printf("transform kernels: %d poses, %s\n", TRANSFORM_POSES,
+           transformMismatches ? ("MISMATCH (" + std::to_string(transformMismatches) + " points)").c_str() : "simd == scalar");
+
+    typedef std::chrono::steady_clock Clock;
+    std::vector<Case> cases = buildCases();
+    BufferPlot plot;
+    int failures = transformMismatches ? 1 : 0;
+
+    printf("%-20s %8s %12s %10s %14s %9s  %s\n", "case", "prims", "pixels", "ns/pixel", "prims/s", "coverage", "golden");
+    for (const Case& c : cases) {
+        // best of as many reps as fit in MIN_CASE_SECONDS
+        double best = 1e30, total = 0.0;
+        int reps = 0;
+        while (reps < 3 || total < MIN_CASE_SECONDS) {
+            plot.clear();
+            Clock::time_point t0 = Clock::now();
+            render(c, plot);
+            double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+            best = std::min(best, sec);
+            total += sec;
+            reps++;
+        }
+
+        std::string path = goldenDir + "/" + c.name + ".pbm";
+        std::string status;
+        double coverage = std::count(plot.px.begin(), plot.px.end(), 1) / (double)plot.px.size();
+        if (coverage < MIN_COVERAGE || coverage > MAX_COVERAGE) {
+            status = "DEGENERATE";
+            failures++;
+        } else if (update) {
+            status = writePbm(path, plot.px) ? "written" : "WRITE FAILED";
+            if (status != "written") failures++;
+        } else {
+            std::vector<uint8_t> golden;
+            if (!readPbm(path, golden)) {
+                status = "MISSING";
+                failures++;
+            } else {
+                long diff = 0;
+                for (size_t i = 0; i < golden.size(); i++) diff += golden[i] != plot.px[i];
+                status = diff ? "MISMATCH (" + std::to_string(diff) + " px)" : "ok";
+                if (diff) failures++;
+            }
+        }
+
+        long prims = primitiveCount(c);
+        char nsPerPixel[32] = "-";
+        if (plot.count) snprintf(nsPerPixel, sizeof(nsPerPixel), "%.3f", best * 1e9 / plot.count);
+        printf("%-20s %8ld %12ld %10s %14.0f %8.1f%%  %s\n", c.name, prims, plot.count, nsPerPixel, prims / best, coverage * 100.0, status.c_str());
+    }
+
+    if (failures) printf("%d case(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,141 @@
+#ifndef SPACE_TRANSFORM2D_H
+#define SPACE_TRANSFORM2D_H
+
+// Batched 2D affine transform for the rocket geometry.
+// Writes into caller storage only; nothing here allocates.
+
+#include <cstdint>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define TRANSFORM2D_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRANSFORM2D_SSE 1
+#endif
+
+struct Point { int x, y; };
+
+// Subpixel output for the rasterizer: 24.8 fixed point
+const int SUBPIXEL_BITS = 8;
+struct SubPoint { int32_t x, y; };
+
+// rotate by angle, then scale, then translate by a whole-pixel offset
+struct Affine2D {
+    float cosA, sinA, scale;
+    int tx, ty;
+
+    Affine2D(Point translate, float angle_deg, float s) {
+        // float angle, double cos/sin: the same rounding the old code had
+        float rad = angle_deg * 3.1415926535 / 180.0;
+        cosA = (float)std::cos((double)rad); sinA = (float)std::sin((double)rad);
+        scale = s;
+        tx = translate.x; ty = translate.y;
+    }
+};
+
+// ===================== KERNELS =====================
+// Integer output truncates the scaled offset before adding the translation,
+// exactly like the old per-vertex (int) casts, so pixels do not move.
+inline void transformPoints(const float* xs, const float* ys, int n,
+                            const Affine2D& m, Point* out) {
+    int i = 0;
+#ifdef TRANSFORM2D_AVX
+    {
+        const __m256 c = _mm256_set1_ps(m.cosA), s = _mm256_set1_ps(m.sinA);
+        const __m256 k = _mm256_set1_ps(m.scale);
+        alignas(32) int rx[8], ry[8];
+        for (; i + 8 <= n; i += 8) {
+            __m256 x = _mm256_loadu_ps(xs + i), y = _mm256_loadu_ps(ys + i);
+            __m256 u = _mm256_mul_ps(k, _mm256_sub_ps(_mm256_mul_ps(x, c), _mm256_mul_ps(y, s)));
+            __m256 v = _mm256_mul_ps(k, _mm256_add_ps(_mm256_mul_ps(x, s), _mm256_mul_ps(y, c)));
+            _mm256_store_si256((__m256i*)rx, _mm256_cvttps_epi32(u));
+            _mm256_store_si256((__m256i*)ry, _mm256_cvttps_epi32(v));
+            for (int j = 0; j < 8; j++) out[i + j] = {rx[j] + m.tx, ry[j] + m.ty};
+        }
+    }
+#endif
+#ifdef TRANSFORM2D_SSE
+    {
+        const __m128 c = _mm_set1_ps(m.cosA), s = _mm_set1_ps(m.sinA);
+        const __m128 k = _mm_set1_ps(m.scale);
+        const __m128i t = _mm_set_epi32(m.ty, m.tx, m.ty, m.tx);
+        for (; i + 4 <= n; i += 4) {
+            __m128 x = _mm_loadu_ps(xs + i), y = _mm_loadu_ps(ys + i);
+            __m128 u = _mm_mul_ps(k, _mm_sub_ps(_mm_mul_ps(x, c), _mm_mul_ps(y, s)));
+            __m128 v = _mm_mul_ps(k, _mm_add_ps(_mm_mul_ps(x, s), _mm_mul_ps(y, c)));
+            // interleave into x,y pairs to match the Point layout
+            __m128 lo = _mm_unpacklo_ps(u, v), hi = _mm_unpackhi_ps(u, v);
+            _mm_storeu_si128((__m128i*)(out + i),     _mm_add_epi32(_mm_cvttps_epi32(lo), t));
+            _mm_storeu_si128((__m128i*)(out + i + 2), _mm_add_epi32(_mm_cvttps_epi32(hi), t));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = {(int)(m.scale * (xs[i] * m.cosA - ys[i] * m.sinA)) + m.tx,
+                  (int)(m.scale * (xs[i] * m.sinA + ys[i] * m.cosA)) + m.ty};
+    }
+}
+
+// Same mapping, rounded to 1/256 pixel instead of truncated to whole pixels.
+inline void transformPointsFixed(const float* xs, const float* ys, int n,
+                                 const Affine2D& m, SubPoint* out) {
+    const float one = (float)(1 << SUBPIXEL_BITS);
+    const int32_t ox = m.tx * (1 << SUBPIXEL_BITS), oy = m.ty * (1 << SUBPIXEL_BITS);
+    int i = 0;
+#ifdef TRANSFORM2D_SSE
+    {
+        const __m128 c = _mm_set1_ps(m.cosA * one), s = _mm_set1_ps(m.sinA * one);
+        const __m128 k = _mm_set1_ps(m.scale);
+        const __m128i t = _mm_set_epi32(oy, ox, oy, ox);
+        for (; i + 4 <= n; i += 4) {
+            __m128 x = _mm_loadu_ps(xs + i), y = _mm_loadu_ps(ys + i);
+            __m128 u = _mm_mul_ps(k, _mm_sub_ps(_mm_mul_ps(x, c), _mm_mul_ps(y, s)));
+            __m128 v = _mm_mul_ps(k, _mm_add_ps(_mm_mul_ps(x, s), _mm_mul_ps(y, c)));
+            __m128 lo = _mm_unpacklo_ps(u, v), hi = _mm_unpackhi_ps(u, v);
+            _mm_storeu_si128((__m128i*)(out + i),     _mm_add_epi32(_mm_cvtps_epi32(lo), t));
+            _mm_storeu_si128((__m128i*)(out + i + 2), _mm_add_epi32(_mm_cvtps_epi32(hi), t));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        float u = m.scale * (xs[i] * m.cosA * one - ys[i] * m.sinA * one);
+        float v = m.scale * (xs[i] * m.sinA * one + ys[i] * m.cosA * one);
+        out[i] = {(int32_t)std::lrint(u) + ox, (int32_t)std::lrint(v) + oy};
+    }
+}
+
+// ===================== ROCKET SHAPE =====================
+// All parts in one table, model space, nose pointing up +y.
+// Parts are contiguous ranges into the transformed output.
+struct ShapePart { int first, count; };
+
+const int ROCKET_VERTEX_COUNT = 19;
+
+constexpr float ROCKET_X[ROCKET_VERTEX_COUNT] = {
+      0, -15,  15,           // nose
+    -15,  15,  15, -15,      // body
+    -15, -15, -25,           // left fin
+     15,  15,  25,           // right fin
+    -10,  10,  15, -15,      // exhaust
+    -15,  15                 // exhaust base
+};
+constexpr float ROCKET_Y[ROCKET_VERTEX_COUNT] = {
+     40,  10,  10,
+     10,  10, -30, -30,
+      0, -25, -35,
+      0, -25, -35,
+    -30, -30, -40, -40,
+    -40, -40
+};
+
+constexpr ShapePart ROCKET_NOSE         = {0, 3};
+constexpr ShapePart ROCKET_BODY         = {3, 4};
+constexpr ShapePart ROCKET_LEFT_FIN     = {7, 3};
+constexpr ShapePart ROCKET_RIGHT_FIN    = {10, 3};
+constexpr ShapePart ROCKET_EXHAUST      = {13, 4};
+constexpr ShapePart ROCKET_EXHAUST_BASE = {17, 2};
+
+#endif
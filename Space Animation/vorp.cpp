@@ -1,9 +1,11 @@
 #include <GL/glut.h>
 #include <vector>
 #include <cmath>
-#include <cstdlib>
 #include <ctime>
 #include <algorithm>
+#include "particles.h"
+#include "transform2d.h"
+#include "raster.h"
 
 
 #define PI 3.1415926535
@@ -28,157 +30,100 @@ const float COLOR_LIGHTGREY[] = {0.75f, 0.75f, 0.75f};
 const float COLOR_BLUE[]    = {0.2f, 0.4f, 1.0f};
 const float COLOR_ORANGE[]  = {0.9f, 0.3f, 0.1f};
 
+// Particles
+const float SIM_DT = 1.0f/60.0f;
+const int FLAMES_PER_TICK = 40;
+const float FLAME_TRAIL = 0.15f;
+ParticlePool<4096> flames;
+StarField<200> stars;
 
-struct Point { int x, y; };
+// Nozzle pose from the last drawn frame; emission happens in update()
+struct ExhaustPose {
+    Point left, right;
+    float angle_deg, scale;
+    bool valid;
+};
+ExhaustPose exhaust = {};
 
-// Liang Barsky Line clipping algorithm
-bool liangBarskyClip(Point &p0, Point &p1, float xmin, float xmax, float ymin, float ymax) {
-    float dx = p1.x - p0.x;
-    float dy = p1.y - p0.y;
 
-    float t0 = 0.0f, t1 = 1.0f;
+// Raster primitives live in raster.h; these feed their pixels to GL
+struct GLPlot {
+    void operator()(int x, int y) { glVertex2i(x, y); }
+};
 
-    float p[4] = {-dx, dx, -dy, dy};
-    float q[4] = {p0.x - xmin, xmax - p0.x, p0.y - ymin, ymax - p0.y};
+ClipRect cameraClip() { return {cam_left, cam_right, cam_bottom, cam_top}; }
 
-    for (int i = 0; i < 4; i++) {
-        if (p[i] == 0) {
-            if (q[i] < 0) return false; // Line parallel & outside
-        } else {
-            float r = q[i] / p[i];
-            if (p[i] < 0) t0 = std::max(t0, r);
-            else t1 = std::min(t1, r);
-        }
-    }
-
-    if (t0 > t1) return false; // No visible part
-
-    Point new_p0 = {int(p0.x + t0 * dx), int(p0.y + t0 * dy)};
-    Point new_p1 = {int(p0.x + t1 * dx), int(p0.y + t1 * dy)};
-    p0 = new_p0; p1 = new_p1;
-    return true;
-}
-
-// Bresenham's line drawing algorithm
 void drawLine(Point p0, Point p1, const float color[3]) {
-    if (!liangBarskyClip(p0, p1, cam_left, cam_right, cam_bottom, cam_top))
-        return;
-
+    GLPlot plot;
     glColor3fv(color);
     glBegin(GL_POINTS);
-
-    int dx = abs(p1.x - p0.x), sx = (p0.x < p1.x ? 1 : -1);
-    int dy = -abs(p1.y - p0.y), sy = (p0.y < p1.y ? 1 : -1);
-    int err = dx + dy;
-
-    while (true) {
-        glVertex2i(p0.x, p0.y);
-        if (p0.x == p1.x && p0.y == p1.y) break;
-        int e2 = 2*err;
-        if (e2 >= dy) { err += dy; p0.x += sx; }
-        if (e2 <= dx) { err += dx; p0.y += sy; }
-    }
+    rasterLine(p0, p1, cameraClip(), plot);
     glEnd();
 }
 
-//center point circle drawing
 void drawCircleOutline(int cx, int cy, int r, const float color[3]) {
+    GLPlot plot;
     glColor3fv(color);
-    int x = 0, y = r;
-    int d = 1 - r;
-    while(y >= x) {
-        glBegin(GL_POINTS);
-        glVertex2i(cx + x, cy + y); glVertex2i(cx - x, cy + y);
-        glVertex2i(cx + x, cy - y); glVertex2i(cx - x, cy - y);
-        glVertex2i(cx + y, cy + x); glVertex2i(cx - y, cy + x);
-        glVertex2i(cx + y, cy - x); glVertex2i(cx - y, cy - x);
-        glEnd();
-        x++;
-        if(d < 0) d += 2*x + 1;
-        else { y--; d += 2*(x - y) + 1; }
-    }
+    glBegin(GL_POINTS);
+    rasterCircleOutline(cx, cy, r, plot);
+    glEnd();
 }
 
-
-// Scan line Fill
-void scanlineFillPolygon(const std::vector<Point>& polygon, const float color[3]) {
-    int minY = polygon[0].y, maxY = polygon[0].y;
-    for(auto&p: polygon){ minY = std::min(minY, p.y); maxY = std::max(maxY, p.y); }
-
-    for(int y = minY; y <= maxY; y++){
-        std::vector<int> intersections;
-        int n = polygon.size();
-        for(int i=0;i<n;i++){
-            Point a = polygon[i], b = polygon[(i+1)%n];
-            if(a.y == b.y) continue;
-            if(y < std::min(a.y,b.y) || y > std::max(a.y,b.y)) continue;
-            int x = a.x + (y - a.y)*(b.x - a.x)/(b.y - a.y);
-            intersections.push_back(x);
-        }
-        std::sort(intersections.begin(), intersections.end());
-        for(int i=0;i+1<intersections.size();i+=2){
-            drawLine({intersections[i], y},{intersections[i+1],y}, color);
-        }
-    }
+void scanlineFillPolygon(const Point* polygon, int n, const float color[3]) {
+    GLPlot plot;
+    glColor3fv(color);
+    glBegin(GL_POINTS);
+    rasterFillPolygon(polygon, n, cameraClip(), plot);
+    glEnd();
 }
 
-//Scan line fill
 void drawFilledCircleScanline(int cx, int cy, int r, const float color[3]){
-    for(int y=-r;y<=r;y++){
-        int dx = (int)sqrt(r*r - y*y);
-        drawLine({cx-dx, cy+y},{cx+dx, cy+y}, color);
-    }
+    GLPlot plot;
+    glColor3fv(color);
+    glBegin(GL_POINTS);
+    rasterFilledCircle(cx, cy, r, cameraClip(), plot);
+    glEnd();
 }
 
-// Random pixel glow stars
+// Persistent star layer
 void drawStars(){
-    glColor3fv(COLOR_WHITE);
     glBegin(GL_POINTS);
-    for(int i=0;i<200;i++) glVertex2i(rand()%800, rand()%600);
+    for(int i=0;i<stars.size();i++){
+        float c = stars.brightness[i];
+        glColor3f(c,c,c);
+        glVertex2i(stars.x[i], stars.y[i]);
+    }
     glEnd();
 }
 
 //Draw Flames
-void drawFlames(Point baseL, Point baseR, float angle_deg, float scale){
-    float rad = (angle_deg-90)*PI/180;
-    float dir_x = cos(rad), dir_y = sin(rad);
-    for(int i=0;i<15;i++){
-        float t = (float)rand()/RAND_MAX;
-        Point base = {(int)(baseL.x + t*(baseR.x-baseL.x)), (int)(baseL.y + t*(baseR.y-baseL.y))};
-        int len = (10+rand()%20)*scale;
-        Point tip = {(int)(base.x+len*dir_x),(int)(base.y+len*dir_y)};
-        glColor3f(1.0f,0.5f+(rand()%50)/100.0f,0.0f);
-        drawLine({base.x-2,base.y},{tip.x,tip.y}, COLOR_RED);
-        drawLine({base.x+2,base.y},{tip.x,tip.y}, COLOR_RED);
+void drawFlames(){
+    for(size_t i=0;i<flames.count;i++){
+        float color[3] = {flames.r[i], flames.g[i], flames.b[i]};
+        Point head = {(int)flames.px[i], (int)flames.py[i]};
+        Point tail = {(int)(flames.px[i]-flames.vx[i]*FLAME_TRAIL), (int)(flames.py[i]-flames.vy[i]*FLAME_TRAIL)};
+        drawLine(tail, head, color);
     }
 }
 
 //Draw Rocket
+void fillPart(const Point* v, ShapePart part, const float color[3]){
+    scanlineFillPolygon(v + part.first, part.count, color);
+}
+
 void drawRocket(Point translate, float angle_deg, float scale){
-    float rad = angle_deg*PI/180;
-    float cosA = cos(rad), sinA = sin(rad);
-    auto transform = [&](const std::vector<Point>& v_in){
-        std::vector<Point> v_out;
-        for(auto &v:v_in){
-            v_out.push_back({(int)(scale*(v.x*cosA - v.y*sinA))+translate.x,
-                             (int)(scale*(v.x*sinA + v.y*cosA))+translate.y});
-        }
-        return v_out;
-    };
-    auto nose = transform({{0,40},{-15,10},{15,10}});
-    auto body = transform({{-15,10},{15,10},{15,-30},{-15,-30}});
-    auto leftFin = transform({{-15,0},{-15,-25},{-25,-35}});
-    auto rightFin= transform({{15,0},{15,-25},{25,-35}});
-    auto exhaust = transform({{-10,-30},{10,-30},{15,-40},{-15,-40}});
-    auto exhaustBase = transform({{-15,-40},{15,-40}});
-
-    scanlineFillPolygon(body,COLOR_WHITE);
-    scanlineFillPolygon(nose,COLOR_RED);
-    scanlineFillPolygon(leftFin,COLOR_RED);
-    scanlineFillPolygon(rightFin,COLOR_RED);
-    scanlineFillPolygon(exhaust, COLOR_LIGHTGREY);
-
-    drawFlames(exhaustBase[0], exhaustBase[1], angle_deg, scale);
+    Point v[ROCKET_VERTEX_COUNT];
+    transformPoints(ROCKET_X, ROCKET_Y, ROCKET_VERTEX_COUNT, Affine2D(translate, angle_deg, scale), v);
+
+    fillPart(v, ROCKET_BODY, COLOR_WHITE);
+    fillPart(v, ROCKET_NOSE, COLOR_RED);
+    fillPart(v, ROCKET_LEFT_FIN, COLOR_RED);
+    fillPart(v, ROCKET_RIGHT_FIN, COLOR_RED);
+    fillPart(v, ROCKET_EXHAUST, COLOR_LIGHTGREY);
+
+    const Point* exhaustBase = v + ROCKET_EXHAUST_BASE.first;
+    exhaust = ExhaustPose{exhaustBase[0], exhaustBase[1], angle_deg, scale, true};
+    drawFlames();
 }
 
 // PLANETS
@@ -222,14 +167,23 @@ void update(int value){
         cam_bottom = 200-50*(1-zoom_t);
         cam_top = 400+50*(1-zoom_t);
     }
+    // emit and integrate once per tick so redraws do not change flame density
+    if(exhaust.valid)
+        emitFlames(flames, exhaust.left.x, exhaust.left.y, exhaust.right.x, exhaust.right.y, exhaust.angle_deg, exhaust.scale, FLAMES_PER_TICK);
+    flames.update(SIM_DT);
     glutPostRedisplay();
     glutTimerFunc(16, update, 0);
 }
 
-void myInit(){ glClearColor(0,0,0,1); }
+void myInit(){
+    glClearColor(0,0,0,1);
+    FastRng skyRng((uint32_t)time(0));
+    stars.generate(skyRng, 800, 600);
+    flames.rng = FastRng((uint32_t)time(0) ^ 0xA5A5A5A5u);
+    flames.setColors(1.0f,0.9f,0.0f, 1.0f,0.1f,0.0f);
+}
 
 int main(int argc, char** argv){
-    srand(time(0));
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
     glutInitWindowSize(800,600);